@@ -21,8 +21,6 @@
 
 #include "IntelArchitecture.h"
 
-#include <boost/range/adaptor/map.hpp>
-
 #include <nc/common/Foreach.h>
 #include <nc/common/Unreachable.h>
 
@@ -52,6 +50,11 @@ IntelArchitecture::IntelArchitecture(Mode mode):
     /* Init registers. */
     initRegisters(IntelRegisters::instance());
 
+    /* Init FPU stack operands. */
+    for (std::size_t i = 0; i < mFpuStackOperands.size(); ++i) {
+        mFpuStackOperands[i] = new FpuStackOperand(static_cast<int>(i));
+    }
+
     /* Init calling conventions. */
     mConventions[AMD64]   = new AMD64CallingConvention(this);
     mConventions[MS64]    = new Microsoft64CallingConvention(this);
@@ -97,17 +100,15 @@ IntelArchitecture::~IntelArchitecture() {
     foreach(core::ir::calls::CallingConvention *convention, mConventions) {
         delete convention;
     }
-    foreach(FpuStackOperand *operand, mFpuStackOperands | boost::adaptors::map_values) {
+    foreach(FpuStackOperand *operand, mFpuStackOperands) {
         delete operand;
     }
 }
 
 FpuStackOperand *IntelArchitecture::fpuStackOperand(int index) const {
-    auto &result = mFpuStackOperands[index];
-    if (!result) {
-        result = new FpuStackOperand(index);
-    }
-    return result;
+    assert(index >= 0 && static_cast<std::size_t>(index) < mFpuStackOperands.size());
+
+    return mFpuStackOperands[index];
 }
 
 } // namespace intel
@@ -101,7 +101,7 @@ public:
     const core::arch::Register *basePointer() const { return mBasePointer; }
 
     /**
-     * \param index FPU stack index.
+     * \param index FPU stack index, from 0 to 7.
      *
      * \returns Valid pointer to the operand for the given FPU stack index.
      */
@@ -123,8 +123,8 @@ private:
     /** Stack frame base pointer register. */
     const core::arch::Register *mBasePointer;
 
-    /** Cached FPU stack operands. */
-    mutable boost::unordered_map<int, FpuStackOperand *> mFpuStackOperands;
+    /** FPU stack operands, created once, so that they can be looked up without locking. */
+    boost::array<FpuStackOperand *, 8> mFpuStackOperands;
 };
 
 } // namespace intel
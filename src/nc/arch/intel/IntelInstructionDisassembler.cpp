@@ -24,10 +24,13 @@
 #include <algorithm>
 #include <cassert>
 
+#include <boost/functional/hash.hpp>
 #include <boost/range/size.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <nc/common/CheckedCast.h>
 #include <nc/common/Unreachable.h>
+#include <nc/common/make_unique.h>
 
 #define UD_NO_STDINT_DEFINE
 #include <libudis86/udis86.h>
@@ -41,10 +44,58 @@ namespace nc {
 namespace arch {
 namespace intel {
 
+/**
+ * Everything libudis86 reports about a memory operand that matters for
+ * building the corresponding DereferenceOperand.
+ */
+struct MemoryOperandKey {
+    int base; ///< Base register.
+    int index; ///< Index register.
+    int scale; ///< Scale of the index.
+    ConstantValue offset; ///< Offset value.
+    SmallBitSize offsetSize; ///< Size of the offset.
+    SmallBitSize addressSize; ///< Size of the address.
+    SmallBitSize size; ///< Size of the memory access.
+
+    MemoryOperandKey(const ud_operand &operand, ConstantValue offsetValue, SmallBitSize addressSize):
+        base(operand.base), index(operand.index), scale(operand.scale), offset(offsetValue),
+        offsetSize(operand.offset), addressSize(addressSize), size(operand.size)
+    {}
+
+    bool operator==(const MemoryOperandKey &that) const {
+        return base == that.base && index == that.index && scale == that.scale && offset == that.offset &&
+               offsetSize == that.offsetSize && addressSize == that.addressSize && size == that.size;
+    }
+};
+
+inline std::size_t hash_value(const MemoryOperandKey &key) {
+    std::size_t result = 0;
+    boost::hash_combine(result, key.base);
+    boost::hash_combine(result, key.index);
+    boost::hash_combine(result, key.scale);
+    boost::hash_combine(result, key.offset);
+    boost::hash_combine(result, key.offsetSize);
+    boost::hash_combine(result, key.addressSize);
+    boost::hash_combine(result, key.size);
+    return result;
+}
+
 class IntelInstructionDisassemblerPrivate {
     const IntelArchitecture *architecture_;
     ud_t ud_obj_;
 
+    /*
+     * Operands used by the instructions disassembled recently. Each clone of
+     * the disassembler has its own copy, so that most operands are found
+     * without taking the locks guarding the caches of the architecture.
+     * The operands are owned by the architecture, so the copies are simply
+     * dropped when they grow beyond MAX_CACHED_OPERANDS entries.
+     */
+    boost::unordered_map<std::pair<ConstantValue, SmallBitSize>, core::arch::ConstantOperand *> constantOperands_;
+    boost::unordered_map<MemoryOperandKey, core::arch::DereferenceOperand *> dereferenceOperands_;
+
+    static const std::size_t MAX_CACHED_OPERANDS = 4096;
+
     public:
 
     IntelInstructionDisassemblerPrivate(const IntelArchitecture *architecture):
@@ -56,6 +107,8 @@ class IntelInstructionDisassemblerPrivate {
         ud_set_mode(&ud_obj_, architecture->bitness());
     }
 
+    const IntelArchitecture *architecture() const { return architecture_; }
+
     std::unique_ptr<IntelInstruction> disassemble(ByteAddr pc, const void *buffer, ByteSize size) {
         ud_set_pc(&ud_obj_, pc);
         ud_set_input_buffer(&ud_obj_, static_cast<unsigned char *>(const_cast<void *>(buffer)), checked_cast<std::size_t>(size));
@@ -744,16 +797,16 @@ class IntelInstructionDisassemblerPrivate {
             case UD_OP_MEM:
                 return getDereference(operand);
             case UD_OP_PTR:
-                return architecture_->constantOperand(SizedValue(operand.lval.ptr.seg * 16 + operand.lval.ptr.off, operand.size));
+                return getConstant(SizedValue(operand.lval.ptr.seg * 16 + operand.lval.ptr.off, operand.size));
             case UD_OP_IMM:
                 /* Signed number, sign-extended to match the size of the other operand. */
-                return architecture_->constantOperand(SizedValue(getSignedValue(operand, operand.size), std::max(SmallBitSize(operand.size), lastOperandSize)));
+                return getConstant(SizedValue(getSignedValue(operand, operand.size), std::max(SmallBitSize(operand.size), lastOperandSize)));
             case UD_OP_JIMM:
-                return architecture_->constantOperand(SizedValue(ud_obj_.pc + getSignedValue(operand, operand.size), architecture_->bitness()));
+                return getConstant(SizedValue(ud_obj_.pc + getSignedValue(operand, operand.size), architecture_->bitness()));
             case UD_OP_CONST:
                 /* This is some small constant value, like in "sar eax, 1". Its size is always zero. */
                 assert(operand.size == 0);
-                return architecture_->constantOperand(SizedValue(operand.lval.ubyte, 8));
+                return getConstant(SizedValue(operand.lval.ubyte, 8));
             case UD_OP_REG:
                 return getRegisterOperand(operand.base);
             default:
@@ -941,40 +994,83 @@ class IntelInstructionDisassemblerPrivate {
         return architecture_->registerOperand(number);
     }
 
+    core::arch::ConstantOperand *getConstant(const SizedValue &value) {
+        if (constantOperands_.size() >= MAX_CACHED_OPERANDS) {
+            constantOperands_.clear();
+        }
+
+        auto &result = constantOperands_[std::make_pair(value.value(), value.size())];
+        if (!result) {
+            result = architecture_->constantOperand(value);
+        }
+        return result;
+    }
+
     core::arch::DereferenceOperand *getDereference(const ud_operand &operand) {
         assert(operand.type == UD_OP_MEM);
 
+        auto offsetValue = SizedValue(getUnsignedValue(operand, operand.offset), operand.offset);
+
+        /*
+         * Absolute and RIP-relative addresses are mostly unique to the instruction
+         * using them. Interning such operands would only fill the caches, so the
+         * instruction gets operands of its own, except for the constant.
+         */
+        if (operand.base == UD_R_RIP || (operand.base == UD_NONE && operand.scale == 0)) {
+            core::arch::Operand *address = getRegisterOperand(operand.base);
+
+            if (offsetValue.value() || !address) {
+                core::arch::ConstantOperand *offset = architecture_->constantOperand(offsetValue);
+
+                if (address) {
+                    address = new core::arch::AdditionOperand(address, offset, ud_obj_.adr_mode);
+                } else {
+                    address = offset;
+                }
+            }
+
+            return new core::arch::DereferenceOperand(address, operand.size);
+        }
+
+        if (dereferenceOperands_.size() >= MAX_CACHED_OPERANDS) {
+            dereferenceOperands_.clear();
+        }
+
+        auto &result = dereferenceOperands_[MemoryOperandKey(operand, offsetValue.value(), ud_obj_.adr_mode)];
+        if (result) {
+            return result;
+        }
+
         core::arch::Operand *address = getRegisterOperand(operand.base);
 
         if (operand.scale != 0) {
             if (core::arch::Operand *index = getRegisterOperand(operand.index)) {
                 if (operand.scale != 1) {
-                    index = new core::arch::MultiplicationOperand(
+                    index = architecture_->multiplicationOperand(
                         index,
-                        architecture_->constantOperand(SizedValue(operand.scale, ud_obj_.adr_mode)),
+                        getConstant(SizedValue(operand.scale, ud_obj_.adr_mode)),
                         ud_obj_.adr_mode);
                 }
                 if (address) {
-                    address = new core::arch::AdditionOperand(address, index, ud_obj_.adr_mode);
+                    address = architecture_->additionOperand(address, index, ud_obj_.adr_mode);
                 } else {
                     address = index;
                 }
             }
         }
 
-        auto offsetValue = SizedValue(getUnsignedValue(operand, operand.offset), operand.offset);
-
         if (offsetValue.value() || !address) {
-            core::arch::ConstantOperand *offset = architecture_->constantOperand(offsetValue);
+            core::arch::ConstantOperand *offset = getConstant(offsetValue);
 
             if (address) {
-                address = new core::arch::AdditionOperand(address, offset, ud_obj_.adr_mode);
+                address = architecture_->additionOperand(address, offset, ud_obj_.adr_mode);
             } else {
                 address = offset;
             }
         }
 
-        return new core::arch::DereferenceOperand(address, operand.size);
+        result = architecture_->dereferenceOperand(address, operand.size);
+        return result;
     }
 };
 
@@ -988,6 +1084,10 @@ std::unique_ptr<core::arch::Instruction> IntelInstructionDisassembler::disassemb
     return impl_->disassemble(pc, buffer, size);
 }
 
+std::unique_ptr<core::arch::disasm::InstructionDisassembler> IntelInstructionDisassembler::clone() const {
+    return std::make_unique<IntelInstructionDisassembler>(impl_->architecture());
+}
+
 } // namespace intel
 } // namespace arch
 } // namespace nc
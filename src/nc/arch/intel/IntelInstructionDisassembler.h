@@ -52,6 +52,8 @@ class IntelInstructionDisassembler: public core::arch::disasm::InstructionDisass
     virtual ~IntelInstructionDisassembler();
 
     std::unique_ptr<core::arch::Instruction> disassemble(ByteAddr pc, const void *buffer, ByteSize size) const override;
+
+    std::unique_ptr<core::arch::disasm::InstructionDisassembler> clone() const override;
 };
 
 } // namespace intel
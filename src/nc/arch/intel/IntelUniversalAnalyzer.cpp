@@ -21,12 +21,16 @@
 
 #include "IntelUniversalAnalyzer.h"
 
+#include <cstring> /* strrchr() */
+
 #include <nc/common/Conversions.h>
 #include <nc/common/Foreach.h>
 #include <nc/common/make_unique.h>
 
 #include <nc/core/Module.h>
 #include <nc/core/Context.h>
+#include <nc/core/ir/CFG.h>
+#include <nc/core/ir/DominatorTree.h>
 #include <nc/core/ir/Program.h>
 #include <nc/core/ir/Statements.h>
 #include <nc/core/ir/Terms.h>
@@ -89,11 +93,11 @@ void IntelUniversalAnalyzer::detectCallingConvention(core::Context *context, con
 
     if (architecture->bitness() == 32) {
         if (auto addr = descriptor.entryAddress()) {
-            const QString &symbol = context->module()->getName(*addr);
-            int index = symbol.lastIndexOf(QChar('@'));
-            if (index != -1) {
+            const char *symbol = context->module()->symbols().getUtf8Name(*addr);
+            const char *suffix = symbol ? strrchr(symbol, '@') : NULL;
+            if (suffix) {
                 ByteSize argumentsSize;
-                if (stringToInt(symbol.mid(index + 1), &argumentsSize)) {
+                if (stringToInt(QString::fromLatin1(suffix + 1), &argumentsSize)) {
                     context->callsData()->setCallingConvention(descriptor, architecture->callingConvention(IntelArchitecture::STDCALL));
                     checked_cast<core::ir::calls::GenericDescriptorAnalyzer *>(context->callsData()->getDescriptorAnalyzer(descriptor))->setArgumentsSize(argumentsSize);
                     return;
@@ -119,7 +123,11 @@ void IntelUniversalAnalyzer::analyzeDataflow(core::Context *context, const core:
     std::unique_ptr<core::ir::dflow::Dataflow> dataflow(new core::ir::dflow::Dataflow());
 
     intel::IntelDataflowAnalyzer analyzer(*dataflow, context->module()->architecture(), context->callsData());
-    analyzer.analyze(function, context->cancellationToken());
+    if (context->sparseDataflow()) {
+        analyzer.analyzeSparsely(function, *context->getCfg(function), *context->getDominatorTree(function), context->cancellationToken());
+    } else {
+        analyzer.analyze(function, *context->getCfg(function), context->cancellationToken());
+    }
 
     context->setDataflow(function, std::move(dataflow));
 }
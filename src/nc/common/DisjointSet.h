@@ -25,7 +25,7 @@
 namespace nc {
 
 /**
- * Template class implementing disjoint set using weighted union and path compression heuristics.
+ * Template class implementing disjoint set using weighted union and path halving heuristics.
  *
  * It can be used like this:
  *
@@ -97,15 +97,18 @@ class DisjointSet {
     private:
 
     /**
-     * Finds a representative of the set using path compression.
+     * Finds a representative of the set using path halving.
+     * Works iteratively, so long paths cannot overflow the stack.
      *
      * \return The representative.
      */
     DisjointSet<T> *findSetImpl() const {
-        if (parent_ != this) {
-            parent_ = parent_->findSetImpl();
+        const DisjointSet<T> *node = this;
+        while (node->parent_ != node) {
+            node->parent_ = node->parent_->parent_;
+            node = node->parent_;
         }
-        return parent_;
+        return const_cast<DisjointSet<T> *>(node);
     }
 };
 
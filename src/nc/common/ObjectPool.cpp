@@ -0,0 +1,347 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ObjectPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <new>
+#include <utility>
+
+#include <nc/common/Foreach.h>
+
+#ifdef NC_USE_THREADS
+#include <QMutexLocker>
+#endif
+
+namespace nc {
+
+namespace {
+
+/**
+ * \param size Size of a block.
+ *
+ * \return Index of the size class of the block.
+ */
+inline std::size_t getSizeClass(std::size_t size) {
+    return size == 0 ? 0 : (size - 1) / ObjectPool::ALIGNMENT;
+}
+
+/** Minimal amount of free memory, in chunks, worth looking for unused chunks. */
+const std::size_t TRIM_CHUNK_COUNT = 4;
+
+/** Beginning of a chunk and its index. */
+typedef std::pair<const char *, std::size_t> ChunkStart;
+
+/**
+ * Orders chunk starts and pointers by address.
+ */
+struct AddressLess {
+    bool operator()(const ChunkStart &a, const ChunkStart &b) const {
+        return std::less<const char *>()(a.first, b.first);
+    }
+    bool operator()(const char *a, const ChunkStart &b) const {
+        return std::less<const char *>()(a, b.first);
+    }
+};
+
+/**
+ * \param starts Chunk starts sorted by address.
+ * \param pointer Pointer to a block inside one of the chunks.
+ *
+ * 
+eturn Index of the chunk containing the block.
+ */
+inline std::size_t findChunk(const std::vector<ChunkStart> &starts, const void *pointer) {
+    std::vector<ChunkStart>::const_iterator i =
+        std::upper_bound(starts.begin(), starts.end(), static_cast<const char *>(pointer), AddressLess());
+    assert(i != starts.begin());
+    return (--i)->second;
+}
+
+} // anonymous namespace
+
+/**
+ * Free lists of one thread.
+ */
+class ObjectPool::ThreadCache: boost::noncopyable {
+    ObjectPool *pool_; ///< Pool the blocks belong to.
+
+    public:
+
+    FreeList lists[SIZE_CLASS_COUNT]; ///< Free lists, one per size class.
+
+    /**
+     * Constructor.
+     *
+     * \param pool Valid pointer to the pool the blocks belong to.
+     */
+    explicit ThreadCache(ObjectPool *pool): pool_(pool) {}
+
+    /**
+     * Destructor. Gives all the blocks back to the pool.
+     */
+    ~ThreadCache() {
+        for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+            if (lists[i].head) {
+                pool_->giveBack(i, lists[i]);
+            }
+        }
+    }
+};
+
+ObjectPool::ObjectPool(std::size_t chunkSize):
+    chunkSize_(chunkSize), current_(NULL), end_(NULL), batches_(SIZE_CLASS_COUNT),
+    freeBytes_(0), trimThreshold_(TRIM_CHUNK_COUNT * chunkSize)
+{
+    assert(chunkSize_ >= MAX_BLOCK_SIZE * BATCH_SIZE);
+}
+
+ObjectPool::~ObjectPool() {
+    /* Let the current thread's cache give its blocks back while the pool is alive. */
+#ifdef NC_USE_THREADS
+    caches_.setLocalData(NULL);
+#else
+    cache_.reset();
+#endif
+    foreach (const Chunk &chunk, chunks_) {
+        ::operator delete(chunk.begin);
+    }
+}
+
+ObjectPool::ThreadCache &ObjectPool::localCache() {
+#ifdef NC_USE_THREADS
+    ThreadCache *cache = caches_.localData();
+    if (!cache) {
+        cache = new ThreadCache(this);
+        caches_.setLocalData(cache);
+    }
+    return *cache;
+#else
+    if (!cache_) {
+        cache_.reset(new ThreadCache(this));
+    }
+    return *cache_;
+#endif
+}
+
+void *ObjectPool::allocate(std::size_t size) {
+    if (size > MAX_BLOCK_SIZE) {
+        return ::operator new(size);
+    }
+
+    std::size_t sizeClass = getSizeClass(size);
+    FreeList &list = localCache().lists[sizeClass];
+
+    if (!list.head) {
+        refill(sizeClass, list);
+    }
+
+    FreeBlock *block = list.head;
+    list.head = block->next;
+    --list.length;
+    return block;
+}
+
+void ObjectPool::deallocate(void *pointer, std::size_t size) {
+    if (pointer == NULL) {
+        return;
+    }
+
+    if (size > MAX_BLOCK_SIZE) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    std::size_t sizeClass = getSizeClass(size);
+    FreeList &list = localCache().lists[sizeClass];
+
+    FreeBlock *block = static_cast<FreeBlock *>(pointer);
+    block->next = list.head;
+    list.head = block;
+    ++list.length;
+
+    /* Do not let a thread deleting what others created hoard the memory. */
+    if (list.length >= 2 * BATCH_SIZE) {
+        FreeList batch;
+        batch.head = list.head;
+        batch.length = BATCH_SIZE;
+
+        FreeBlock *last = list.head;
+        for (std::size_t i = 1; i < BATCH_SIZE; ++i) {
+            last = last->next;
+        }
+        list.head = last->next;
+        list.length -= BATCH_SIZE;
+        last->next = NULL;
+
+        giveBack(sizeClass, batch);
+    }
+}
+
+void ObjectPool::refill(std::size_t sizeClass, FreeList &list) {
+    assert(list.head == NULL);
+
+    std::size_t blockSize = (sizeClass + 1) * ALIGNMENT;
+    char *begin;
+    std::size_t count;
+
+    {
+#ifdef NC_USE_THREADS
+        QMutexLocker locker(&mutex_);
+#endif
+
+        std::vector<FreeList> &batches = batches_[sizeClass];
+        if (!batches.empty()) {
+            list = batches.back();
+            batches.pop_back();
+            freeBytes_ -= list.length * blockSize;
+            return;
+        }
+
+        if (static_cast<std::size_t>(end_ - current_) < blockSize) {
+            Chunk chunk;
+            chunk.begin = static_cast<char *>(::operator new(chunkSize_));
+            chunk.used = 0;
+            chunks_.push_back(chunk);
+            current_ = chunk.begin;
+            end_ = current_ + chunkSize_;
+        }
+
+        /* Not std::min(): it would take BATCH_SIZE by reference, which needs a definition. */
+        count = static_cast<std::size_t>(end_ - current_) / blockSize;
+        if (count > BATCH_SIZE) {
+            count = BATCH_SIZE;
+        }
+        begin = current_;
+        current_ += count * blockSize;
+        chunks_.back().used += count * blockSize;
+    }
+
+    /* Link the carved blocks outside the lock. */
+    FreeBlock *head = NULL;
+    for (std::size_t i = count; i > 0; --i) {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(begin + (i - 1) * blockSize);
+        block->next = head;
+        head = block;
+    }
+    list.head = head;
+    list.length = count;
+}
+
+void ObjectPool::giveBack(std::size_t sizeClass, const FreeList &batch) {
+    assert(batch.head != NULL);
+
+#ifdef NC_USE_THREADS
+    QMutexLocker locker(&mutex_);
+#endif
+
+    batches_[sizeClass].push_back(batch);
+    freeBytes_ += batch.length * (sizeClass + 1) * ALIGNMENT;
+
+    if (freeBytes_ >= trimThreshold_) {
+        trim();
+    }
+}
+
+void ObjectPool::trim() {
+    std::vector<ChunkStart> starts;
+    starts.reserve(chunks_.size());
+    for (std::size_t i = 0; i < chunks_.size(); ++i) {
+        starts.push_back(ChunkStart(chunks_[i].begin, i));
+    }
+    std::sort(starts.begin(), starts.end(), AddressLess());
+
+    /* Count the free bytes in each chunk. */
+    std::vector<std::size_t> freeBytes(chunks_.size(), 0);
+    for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        std::size_t blockSize = (sizeClass + 1) * ALIGNMENT;
+        foreach (const FreeList &batch, batches_[sizeClass]) {
+            for (FreeBlock *block = batch.head; block; block = block->next) {
+                freeBytes[findChunk(starts, block)] += blockSize;
+            }
+        }
+    }
+
+    std::vector<bool> unused(chunks_.size(), false);
+    bool found = false;
+    for (std::size_t i = 0; i < chunks_.size(); ++i) {
+        if (freeBytes[i] == chunks_[i].used) {
+            unused[i] = true;
+            found = true;
+        }
+    }
+
+    if (found) {
+        /* Relink the blocks of the chunks staying alive into new batches. */
+        for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+            std::vector<FreeList> batches;
+            FreeList list;
+            foreach (const FreeList &batch, batches_[sizeClass]) {
+                FreeBlock *next;
+                for (FreeBlock *block = batch.head; block; block = next) {
+                    next = block->next;
+                    if (!unused[findChunk(starts, block)]) {
+                        block->next = list.head;
+                        list.head = block;
+                        if (++list.length == BATCH_SIZE) {
+                            batches.push_back(list);
+                            list = FreeList();
+                        }
+                    }
+                }
+            }
+            if (list.head) {
+                batches.push_back(list);
+            }
+            batches_[sizeClass].swap(batches);
+        }
+
+        /* The last chunk is being carved. */
+        if (unused.back()) {
+            current_ = NULL;
+            end_ = NULL;
+        }
+
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < chunks_.size(); ++i) {
+            if (unused[i]) {
+                freeBytes_ -= chunks_[i].used;
+                ::operator delete(chunks_[i].begin);
+            } else {
+                chunks_[kept++] = chunks_[i];
+            }
+        }
+        chunks_.resize(kept);
+    }
+
+    /* Look again only after a comparable amount of memory is freed, so that the work is amortized. */
+    std::size_t usedBytes = 0;
+    foreach (const Chunk &chunk, chunks_) {
+        usedBytes += chunk.used;
+    }
+    trimThreshold_ = freeBytes_ + std::max(TRIM_CHUNK_COUNT * chunkSize_, usedBytes / 2);
+}
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
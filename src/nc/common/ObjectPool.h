@@ -0,0 +1,174 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#ifdef NC_USE_THREADS
+#include <QMutex>
+#include <QThreadStorage>
+#endif
+
+namespace nc {
+
+/**
+ * Allocator of small objects of varying sizes.
+ *
+ * Memory is taken from the system in large chunks and carved into blocks
+ * of size classes, ALIGNMENT bytes apart. Each thread allocates from and
+ * frees to its own free lists, without locking. The threads exchange free
+ * blocks with the shared part of the pool in batches of BATCH_SIZE blocks:
+ * a thread takes a batch when its free list of a size class runs empty,
+ * and gives one back when the list grows too long, e.g. when the thread
+ * deletes objects created by other threads. When enough free memory has
+ * accumulated in the shared part, chunks all of whose blocks are there
+ * are returned to the system.
+ *
+ * Requests larger than the largest size class are forwarded
+ * to the global operator new and operator delete.
+ *
+ * Pools backing class-level operator new and operator delete are meant to
+ * be created with new and never destroyed: objects of the class can be
+ * deleted during the destruction of static objects, and memory cached by
+ * a thread is returned to the pool when the thread finishes.
+ */
+class ObjectPool: boost::noncopyable {
+    public:
+
+    /** Alignment and granularity of block sizes. */
+    static const std::size_t ALIGNMENT = 16;
+
+    /** Size of the largest size class. */
+    static const std::size_t MAX_BLOCK_SIZE = 256;
+
+    /** Number of size classes. */
+    static const std::size_t SIZE_CLASS_COUNT = MAX_BLOCK_SIZE / ALIGNMENT;
+
+    /** Number of blocks moved between a thread and the shared part of the pool at once. */
+    static const std::size_t BATCH_SIZE = 64;
+
+    private:
+
+    /** Free block, linked into a free list. */
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    /** List of free blocks of the same size class. */
+    struct FreeList {
+        FreeBlock *head; ///< First block in the list. Can be NULL.
+        std::size_t length; ///< Number of blocks in the list.
+
+        FreeList(): head(NULL), length(0) {}
+    };
+
+    /** Chunk of memory taken from the system. */
+    struct Chunk {
+        char *begin; ///< Beginning of the chunk.
+        std::size_t used; ///< Number of bytes carved into blocks.
+    };
+
+    class ThreadCache;
+
+    std::size_t chunkSize_; ///< Size of a chunk in bytes.
+    std::vector<Chunk> chunks_; ///< Allocated chunks, the one being carved last.
+    char *current_; ///< Beginning of the unused part of the last chunk.
+    char *end_; ///< End of the last chunk.
+    std::vector<std::vector<FreeList> > batches_; ///< Batches of free blocks given back by the threads, per size class.
+    std::size_t freeBytes_; ///< Total size of the blocks in the batches.
+    std::size_t trimThreshold_; ///< Value of freeBytes_ at which unused chunks are looked for.
+
+#ifdef NC_USE_THREADS
+    QMutex mutex_; ///< Mutex guarding all the above.
+    QThreadStorage<ThreadCache *> caches_; ///< Free lists of each thread.
+#else
+    std::unique_ptr<ThreadCache> cache_; ///< Free lists.
+#endif
+
+    public:
+
+    /**
+     * Constructor.
+     *
+     * \param chunkSize Size of chunks requested from the system, in bytes.
+     */
+    explicit ObjectPool(std::size_t chunkSize = 256 * 1024);
+
+    /**
+     * Destructor. Releases all the chunks.
+     */
+    ~ObjectPool();
+
+    /**
+     * Allocates a block of memory.
+     *
+     * \param size Size of the block.
+     *
+     * \return Valid pointer to the block, aligned by ALIGNMENT.
+     */
+    void *allocate(std::size_t size);
+
+    /**
+     * Frees a block of memory.
+     *
+     * \param pointer Pointer to the block allocated by this pool. Can be NULL.
+     * \param size Size of the block passed to allocate().
+     */
+    void deallocate(void *pointer, std::size_t size);
+
+    private:
+
+    /**
+     * \return The free lists of the current thread.
+     */
+    ThreadCache &localCache();
+
+    /**
+     * Fills an empty free list of the current thread with a batch of blocks.
+     *
+     * \param sizeClass Index of the size class.
+     * \param list Empty free list of this size class.
+     */
+    void refill(std::size_t sizeClass, FreeList &list);
+
+    /**
+     * Gives a batch of free blocks back to the shared part of the pool.
+     *
+     * \param sizeClass Index of the size class.
+     * \param batch Nonempty list of free blocks of this size class.
+     */
+    void giveBack(std::size_t sizeClass, const FreeList &batch);
+
+    /**
+     * Returns to the system the chunks all of whose blocks are in the batches.
+     * Must be called with the mutex locked.
+     */
+    void trim();
+};
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
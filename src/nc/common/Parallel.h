@@ -0,0 +1,167 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <exception> /* std::exception_ptr */
+#include <memory>
+#include <vector>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/size.hpp>
+
+#ifdef NC_USE_THREADS
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#endif
+
+namespace nc {
+
+namespace detail {
+
+#ifdef NC_USE_THREADS
+
+/**
+ * State shared by the workers of a single parallelForEach() call.
+ */
+template<class Range, class Functor>
+class ParallelForEachState {
+    const Range &range_; ///< Range being processed.
+    Functor &functor_; ///< Functor called on the elements of the range.
+    int size_; ///< Number of elements in the range.
+    QAtomicInt next_; ///< Index of the next element to be processed.
+    QMutex mutex_; ///< Mutex guarding the exception.
+    std::exception_ptr exception_; ///< First exception thrown by the functor.
+
+    public:
+
+    ParallelForEachState(const Range &range, Functor &functor):
+        range_(range), functor_(functor), size_(static_cast<int>(boost::size(range))), next_(0)
+    {}
+
+    /**
+     * Processes elements of the range until there are no more of them,
+     * or until the functor throws an exception in some thread.
+     */
+    void work() {
+        int index;
+        while ((index = next_.fetchAndAddOrdered(1)) < size_) {
+            try {
+                functor_(boost::begin(range_)[index]);
+            } catch (...) {
+                QMutexLocker locker(&mutex_);
+                if (!exception_) {
+                    exception_ = std::current_exception();
+                }
+                next_.fetchAndStoreOrdered(size_);
+            }
+        }
+    }
+
+    /**
+     * Rethrows the first exception thrown by the functor, if any.
+     */
+    void rethrow() {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+};
+
+/**
+ * Runnable executing the work of a parallelForEach() call in a pool thread.
+ */
+template<class State>
+class ParallelForEachWorker: public QRunnable {
+    State &state_;
+
+    public:
+
+    ParallelForEachWorker(State &state): state_(state) { setAutoDelete(false); }
+
+    virtual void run() override { state_.work(); }
+};
+
+#endif /* NC_USE_THREADS */
+
+} // namespace detail
+
+/**
+ * Calls a functor on every element of a random access range,
+ * distributing the elements among at most the given number of threads.
+ *
+ * The functor must be safe to call concurrently on different elements.
+ * The calling thread takes part in the work, and the function returns
+ * only when all the elements have been processed. If the functor throws,
+ * no new elements are handed out and the first exception thrown is
+ * rethrown in the calling thread.
+ *
+ * If threads are disabled or threadCount is less than two, the elements are
+ * processed sequentially in their order in the range.
+ *
+ * \param range         Random access range.
+ * \param threadCount   Maximal number of threads to use.
+ * \param functor       Functor taking an element of the range.
+ */
+template<class Range, class Functor>
+void parallelForEach(const Range &range, int threadCount, Functor functor) {
+    std::size_t size = boost::size(range);
+
+#ifdef NC_USE_THREADS
+    if (threadCount > 1 && size > 1) {
+        if (static_cast<std::size_t>(threadCount) > size) {
+            threadCount = static_cast<int>(size);
+        }
+
+        typedef detail::ParallelForEachState<Range, Functor> State;
+        State state(range, functor);
+
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(threadCount - 1);
+
+        std::vector<std::unique_ptr<detail::ParallelForEachWorker<State>>> workers;
+        for (int i = 1; i < threadCount; ++i) {
+            workers.push_back(std::unique_ptr<detail::ParallelForEachWorker<State>>(new detail::ParallelForEachWorker<State>(state)));
+            threadPool.start(workers.back().get());
+        }
+
+        state.work();
+        threadPool.waitForDone();
+        state.rethrow();
+        return;
+    }
+#else
+    (void)threadCount;
+#endif
+
+    for (std::size_t i = 0; i < size; ++i) {
+        functor(boost::begin(range)[i]);
+    }
+}
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,107 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace nc {
+
+/**
+ * Union-find structure over elements identified by dense indices 0, 1, ..., size() - 1.
+ *
+ * Parents and ranks are stored in plain arrays. Union is done by rank,
+ * find uses iterative path halving, so that no recursion happens
+ * however long the paths are.
+ */
+class UnionFind {
+    std::vector<std::size_t> parents_; ///< Parent of each element.
+    std::vector<unsigned char> ranks_; ///< Rank of each element.
+
+    public:
+
+    /**
+     * \return Number of elements.
+     */
+    std::size_t size() const { return parents_.size(); }
+
+    /**
+     * Adds a new singleton set.
+     *
+     * \return Index of the new element.
+     */
+    std::size_t add() {
+        std::size_t index = parents_.size();
+        parents_.push_back(index);
+        ranks_.push_back(0);
+        return index;
+    }
+
+    /**
+     * Finds the representative of the set containing the given element.
+     *
+     * \param index Index of the element.
+     *
+     * \return Index of the representative.
+     */
+    std::size_t find(std::size_t index) {
+        assert(index < size());
+
+        while (parents_[index] != index) {
+            parents_[index] = parents_[parents_[index]];
+            index = parents_[index];
+        }
+        return index;
+    }
+
+    /**
+     * Merges the sets containing the given elements.
+     *
+     * \param a Index of an element.
+     * \param b Index of an element.
+     *
+     * \return Index of the representative of the merged set.
+     */
+    std::size_t unite(std::size_t a, std::size_t b) {
+        a = find(a);
+        b = find(b);
+
+        if (a == b) {
+            return a;
+        }
+        if (ranks_[a] < ranks_[b]) {
+            parents_[a] = b;
+            return b;
+        }
+        parents_[b] = a;
+        if (ranks_[a] == ranks_[b]) {
+            ++ranks_[a];
+        }
+        return a;
+    }
+};
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
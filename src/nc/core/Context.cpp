@@ -24,6 +24,7 @@
 #include <cstdint> /* For std::uintptr_t. */
 
 #include <QFile>
+#include <QMutexLocker>
 #include <QTextStream>
 
 #include <nc/common/Foreach.h>
@@ -34,9 +35,13 @@
 #include <nc/core/arch/Architecture.h>
 #include <nc/core/arch/Instructions.h>
 #include <nc/core/arch/disasm/Disassembler.h>
+#include <nc/core/arch/disasm/RecursiveDisassembler.h>
 #include <nc/core/image/Image.h>
 #include <nc/core/input/Parser.h>
 #include <nc/core/input/ParserRepository.h>
+#include <nc/core/ir/CFG.h>
+#include <nc/core/ir/DominatorTree.h>
+#include <nc/core/ir/Function.h>
 #include <nc/core/ir/Functions.h>
 #include <nc/core/ir/Program.h>
 #include <nc/core/ir/calls/CallingConventionDetector.h>
@@ -54,7 +59,9 @@ namespace core {
 
 Context::Context():
     module_(std::make_shared<Module>()),
-    instructions_(std::make_shared<const arch::Instructions>())
+    instructions_(std::make_shared<const arch::Instructions>()),
+    threadCount_(1),
+    sparseDataflow_(false)
 {}
 
 Context::~Context() {}
@@ -103,63 +110,127 @@ void Context::setTermToFunction(std::unique_ptr<ir::misc::TermToFunction> termTo
 void Context::setDataflow(const ir::Function *function, std::unique_ptr<ir::dflow::Dataflow> dataflow) {
     assert(function);
     assert(dataflow);
+
+    QMutexLocker locker(&mutex_);
     auto &entry = dataflows_[function];
     assert(!entry);
     entry = std::move(dataflow);
 }
 
 const ir::dflow::Dataflow *Context::getDataflow(const ir::Function *function) const {
+    QMutexLocker locker(&mutex_);
     return nc::find(dataflows_, function).get();
 }
 
 void Context::setUsage(const ir::Function *function, std::unique_ptr<ir::usage::Usage> usage) {
     assert(function);
     assert(usage);
+
+    QMutexLocker locker(&mutex_);
     auto &entry = usages_[function];
     assert(!entry);
     entry = std::move(usage);
 }
 
 const ir::usage::Usage *Context::getUsage(const ir::Function *function) const {
+    QMutexLocker locker(&mutex_);
     return nc::find(usages_, function).get();
 }
 
 void Context::setTypes(const ir::Function *function, std::unique_ptr<ir::types::Types> types) {
     assert(function);
     assert(types);
+
+    QMutexLocker locker(&mutex_);
     auto &entry = types_[function];
     assert(!entry);
     entry = std::move(types);
 }
 
 const ir::types::Types *Context::getTypes(const ir::Function *function) const {
+    QMutexLocker locker(&mutex_);
     return nc::find(types_, function).get();
 }
 
 void Context::setVariables(const ir::Function *function, std::unique_ptr<ir::vars::Variables> variables) {
     assert(function);
     assert(variables);
+
+    QMutexLocker locker(&mutex_);
     auto &entry = variables_[function];
     assert(!entry);
     entry = std::move(variables);
 }
 
 const ir::vars::Variables *Context::getVariables(const ir::Function *function) const {
+    QMutexLocker locker(&mutex_);
     return nc::find(variables_, function).get();
 }
 
 void Context::setRegionGraph(const ir::Function *function, std::unique_ptr<ir::cflow::Graph> graph) {
     assert(function);
     assert(graph);
+
+    QMutexLocker locker(&mutex_);
     auto &entry = regionGraphs_[function];
     assert(!entry);
     entry = std::move(graph);
 }
 
 const ir::cflow::Graph *Context::getRegionGraph(const ir::Function *function) const {
+    QMutexLocker locker(&mutex_);
     return nc::find(regionGraphs_, function).get();
 }
 
+void Context::setCfg(const ir::Function *function, std::unique_ptr<ir::CFG> cfg) {
+    assert(function);
+    assert(cfg);
+
+    QMutexLocker locker(&mutex_);
+    auto &entry = cfgs_[function];
+    assert(!entry);
+    entry = std::move(cfg);
+}
+
+const ir::CFG *Context::getCfg(const ir::Function *function) const {
+    QMutexLocker locker(&mutex_);
+    return nc::find(cfgs_, function).get();
+}
+
+const ir::DominatorTree *Context::getDominatorTree(const ir::Function *function) const {
+    return getDominatorTree(dominatorTrees_, function, ir::DominatorTree::DOMINATORS);
+}
+
+const ir::DominatorTree *Context::getPostDominatorTree(const ir::Function *function) const {
+    return getDominatorTree(postDominatorTrees_, function, ir::DominatorTree::POSTDOMINATORS);
+}
+
+const ir::DominatorTree *Context::getDominatorTree(DominatorTrees &trees, const ir::Function *function, int kind) const {
+    assert(function);
+
+    {
+        QMutexLocker locker(&mutex_);
+        if (const ir::DominatorTree *tree = nc::find(trees, function).get()) {
+            return tree;
+        }
+    }
+
+    /* Build the tree without holding the lock; if another thread was faster, its tree wins. */
+    std::unique_ptr<ir::DominatorTree> tree;
+    if (const ir::CFG *cfg = getCfg(function)) {
+        tree.reset(new ir::DominatorTree(*cfg, function->entry(), static_cast<ir::DominatorTree::Kind>(kind)));
+    } else {
+        tree.reset(new ir::DominatorTree(ir::CFG(function->basicBlocks()), function->entry(), static_cast<ir::DominatorTree::Kind>(kind)));
+    }
+
+    QMutexLocker locker(&mutex_);
+    auto &entry = trees[function];
+    if (!entry) {
+        entry = std::move(tree);
+    }
+    return entry.get();
+}
+
 void Context::setTree(std::unique_ptr<likec::Tree> tree) {
     assert(tree);
     assert(!tree_);
@@ -225,11 +296,46 @@ void Context::disassemble(const image::ByteSource *source, ByteAddr begin, ByteA
     auto newInstructions = std::make_shared<arch::Instructions>(*instructions());
 
     arch::disasm::Disassembler disassembler(module()->architecture(), newInstructions.get());
-    disassembler.disassemble(source, begin, end, cancellationToken());
+    disassembler.disassembleInParallel(source, begin, end, threadCount(), cancellationToken());
 
     setInstructions(newInstructions);
 }
 
+bool Context::disassembleRecursively() {
+    logToken() << tr("Disassembling code reachable from the entry point and symbols...");
+
+    auto newInstructions = std::make_shared<arch::Instructions>(*instructions());
+
+    arch::disasm::RecursiveDisassembler disassembler(module()->architecture(), newInstructions.get(), module()->image());
+
+    auto isCode = [this](ByteAddr addr) -> bool {
+        const image::Section *section = module()->image()->getSectionContainingAddress(addr);
+        return section && section->isCode();
+    };
+
+    bool haveEntries = false;
+    if (module()->entryPoint() && isCode(*module()->entryPoint())) {
+        disassembler.addEntry(*module()->entryPoint());
+        haveEntries = true;
+    }
+    foreach (ByteAddr addr, module()->symbols().addresses()) {
+        if (isCode(addr)) {
+            disassembler.addEntry(addr);
+            haveEntries = true;
+        }
+    }
+
+    if (!haveEntries) {
+        return false;
+    }
+
+    disassembler.disassemble(cancellationToken());
+
+    setInstructions(newInstructions);
+
+    return true;
+}
+
 void Context::decompile() {
     if (instructions()->all().empty()) {
         disassemble();
@@ -27,6 +27,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/unordered_map.hpp>
 
+#include <QMutex>
 #include <QObject>
 
 #include <nc/common/CancellationToken.h>
@@ -51,6 +52,8 @@ namespace image {
 }
 
 namespace ir {
+    class CFG;
+    class DominatorTree;
     class Function;
     class Functions;
     class Program;
@@ -105,9 +108,25 @@ class Context: public QObject {
     boost::unordered_map<const ir::Function *, std::unique_ptr<ir::types::Types> > types_; ///< Information about types.
     boost::unordered_map<const ir::Function *, std::unique_ptr<ir::vars::Variables> > variables_; ///< Reconstructed variables.
     boost::unordered_map<const ir::Function *, std::unique_ptr<ir::cflow::Graph> > regionGraphs_; ///< Region graphs.
+    boost::unordered_map<const ir::Function *, std::unique_ptr<ir::CFG> > cfgs_; ///< Control flow graphs.
+    typedef boost::unordered_map<const ir::Function *, std::unique_ptr<ir::DominatorTree> > DominatorTrees;
+    mutable DominatorTrees dominatorTrees_; ///< Dominator trees, built on demand.
+    mutable DominatorTrees postDominatorTrees_; ///< Post-dominator trees, built on demand.
     std::unique_ptr<likec::Tree> tree_; ///< Representation of LikeC program.
     LogToken logToken_; ///< Log token.
     CancellationToken cancellationToken_; ///< Cancellation token.
+    int threadCount_; ///< Maximal number of threads used for per-function analyses.
+    bool sparseDataflow_; ///< Whether dataflow is analyzed over an SSA form.
+    mutable QMutex mutex_; ///< Mutex guarding the per-function maps.
+
+    /**
+     * \param trees Cache of trees of the given kind.
+     * \param function Valid pointer to a function.
+     * \param kind ir::DominatorTree::Kind of the tree.
+     *
+     * \return Valid pointer to the cached tree, built if necessary.
+     */
+    const ir::DominatorTree *getDominatorTree(DominatorTrees &trees, const ir::Function *function, int kind) const;
 
 public:
     /**
@@ -279,6 +298,41 @@ public:
      */
     const ir::cflow::Graph *getRegionGraph(const ir::Function *function) const;
 
+    /**
+     * Sets the control flow graph of a function.
+     *
+     * \param[in] function Valid pointer to a function.
+     * \param[in] cfg Valid pointer to the control flow graph of the function's basic blocks.
+     */
+    void setCfg(const ir::Function *function, std::unique_ptr<ir::CFG> cfg);
+
+    /**
+     * \param[in] function Valid pointer to a function.
+     *
+     * \return Pointer to the control flow graph of the given function. Can be NULL.
+     */
+    const ir::CFG *getCfg(const ir::Function *function) const;
+
+    /**
+     * Builds the dominator tree of a function on first request.
+     * The function must not change afterwards.
+     *
+     * \param[in] function Valid pointer to a function.
+     *
+     * \return Valid pointer to the dominator tree of the given function.
+     */
+    const ir::DominatorTree *getDominatorTree(const ir::Function *function) const;
+
+    /**
+     * Builds the post-dominator tree of a function on first request.
+     * The function must not change afterwards.
+     *
+     * \param[in] function Valid pointer to a function.
+     *
+     * \return Valid pointer to the post-dominator tree of the given function.
+     */
+    const ir::DominatorTree *getPostDominatorTree(const ir::Function *function) const;
+
     /**
      * Sets the LikeC tree.
      *
@@ -315,6 +369,31 @@ public:
      */
     const LogToken &logToken() const { return logToken_; }
 
+    /**
+     * Sets the maximal number of threads used for running per-function analyses.
+     *
+     * \param count Number of threads. Values less than two mean single-threaded analysis.
+     */
+    void setThreadCount(int count) { threadCount_ = count; }
+
+    /**
+     * \return Maximal number of threads used for running per-function analyses.
+     */
+    int threadCount() const { return threadCount_; }
+
+    /**
+     * Sets whether dataflow of functions is analyzed over an SSA form of
+     * register and stack accesses, see ir::dflow::DataflowAnalyzer::analyzeSparsely().
+     *
+     * \param value Whether to analyze dataflow over an SSA form.
+     */
+    void setSparseDataflow(bool value) { sparseDataflow_ = value; }
+
+    /**
+     * \return Whether dataflow of functions is analyzed over an SSA form.
+     */
+    bool sparseDataflow() const { return sparseDataflow_; }
+
     public Q_SLOTS:
 
     // TODO: remove all functions in this section.
@@ -340,6 +419,7 @@ public:
 
     /*
      * Disassembles all instructions in the given range of addresses.
+     * Large ranges are split into chunks decoded using up to threadCount() threads.
      *
      * \param source Valid pointer to a byte source.
      * \param begin First address in the range.
@@ -347,9 +427,24 @@ public:
      */
     void disassemble(const image::ByteSource *source, ByteAddr begin, ByteAddr end);
 
+    /**
+     * Disassembles the instructions reachable from the entry point and
+     * the named addresses of the module by following the control flow.
+     *
+     * Targets of indirect jumps and calls, e.g. of jump tables, callbacks
+     * and virtual functions, are not found, so the code reached only this
+     * way is missed.
+     *
+     * \return True if there were any addresses in code sections to start from.
+     */
+    bool disassembleRecursively();
+
     /**
      * Decompile everything.
      * The context must be clean, i.e. not decompiled before.
+     * If there are no instructions, all the code sections are disassembled.
+     * Call disassembleRecursively() before to disassemble only the code
+     * reachable from the entry point and the named addresses.
      */
     void decompile();
 
@@ -22,15 +22,17 @@
 
 #include <nc/config.h>
 
+#include <map>
 #include <memory> /* For std::unique_ptr. */
 
-#include <boost/unordered_map.hpp>
+#include <boost/optional.hpp>
 
 #include <QString>
 
-#include <nc/common/Range.h> /* nc::find */
 #include <nc/common/Types.h>
 
+#include "SymbolTable.h"
+
 namespace nc { namespace core {
 
 namespace arch {
@@ -101,19 +103,45 @@ public:
      * \param[in] address              Address.
      * \param[in] name                 Name for the given address.
      */
-    void addName(ByteAddr address, const QString &name) { mAddress2name[address] = name; }
+    void addName(ByteAddr address, const QString &name) { mSymbols.add(address, name); }
 
     /**
      * \param[in] addr Address.
      *
      * \return Name for the given address, if any, and QString() otherwise.
      */
-    const QString &getName(ByteAddr addr) const { return nc::find(mAddress2name, addr); }
+    QString getName(ByteAddr addr) const { return mSymbols.getName(addr); }
 
     /**
-     * \return All known pairs of addresses and its names.
+     * \return Table of all known addresses and their names.
+     */
+    const SymbolTable &symbols() const { return mSymbols; }
+
+    /**
+     * Remembers a stub jumping to the address stored in a memory slot,
+     * e.g. a PLT entry jumping through its GOT entry.
+     *
+     * \param[in] stubAddress Address of the stub.
+     * \param[in] slotAddress Address of the slot.
      */
-    const boost::unordered_map<ByteAddr, QString> &names() const { return mAddress2name; }
+    void addStub(ByteAddr stubAddress, ByteAddr slotAddress) { mStubs[stubAddress] = slotAddress; }
+
+    /**
+     * \return Mapping from the addresses of stubs to the addresses of the slots they jump through.
+     */
+    const std::map<ByteAddr, ByteAddr> &stubs() const { return mStubs; }
+
+    /**
+     * \return Address of the entry point of the module, if known.
+     */
+    const boost::optional<ByteAddr> &entryPoint() const { return mEntryPoint; }
+
+    /**
+     * Sets the address of the entry point of the module.
+     *
+     * \param[in] address Entry point address.
+     */
+    void setEntryPoint(ByteAddr address) { mEntryPoint = address; }
 
     /**
      * \return Valid pointer to a demangler.
@@ -142,7 +170,13 @@ private:
     std::unique_ptr<image::Image> mImage;
 
     /** Mapping of an address to its name. */
-    boost::unordered_map<ByteAddr, QString> mAddress2name;
+    SymbolTable mSymbols;
+
+    /** Mapping from the addresses of stubs to the addresses of their slots. */
+    std::map<ByteAddr, ByteAddr> mStubs;
+
+    /** Entry point address. */
+    boost::optional<ByteAddr> mEntryPoint;
 
     /** Demangler. */
     std::unique_ptr<mangling::Demangler> mDemangler;
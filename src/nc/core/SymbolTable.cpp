@@ -0,0 +1,264 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring> /* strcmp(), strlen() */
+#include <limits>
+
+#include <boost/functional/hash.hpp>
+
+#include <QByteArray>
+#include <QCoreApplication>
+
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+
+namespace nc {
+namespace core {
+
+namespace {
+
+/**
+ * Minimal number of recently added symbols that triggers a merge.
+ */
+const std::size_t MIN_MERGE_SIZE = 1024;
+
+/**
+ * Minimal number of cells in the hash table of names.
+ */
+const std::size_t MIN_INDEX_SIZE = 256;
+
+/**
+ * \param name Valid pointer to a zero-terminated string.
+ *
+ * \return Hash of the string.
+ */
+inline std::size_t hashName(const char *name) {
+    return boost::hash_range(name, name + strlen(name));
+}
+
+/**
+ * Orders symbols by address, comparing them with plain addresses too.
+ */
+struct AddrLess {
+    template<class Entry>
+    bool operator()(const Entry &entry, ByteAddr addr) const { return entry.addr < addr; }
+
+    template<class Entry>
+    bool operator()(ByteAddr addr, const Entry &entry) const { return addr < entry.addr; }
+};
+
+} // anonymous namespace
+
+SymbolTable::SymbolTable(): namesCount_(0) {}
+
+SymbolTable::~SymbolTable() {}
+
+void SymbolTable::add(ByteAddr addr, const QString &name) {
+    if (name.isEmpty()) {
+        return;
+    }
+
+    uint32_t nameOffset = intern(name);
+
+    auto i = std::lower_bound(entries_.begin(), entries_.end(), addr, AddrLess());
+    if (i != entries_.end() && i->addr == addr) {
+        i->nameOffset = nameOffset;
+        return;
+    }
+
+    recentEntries_[addr] = nameOffset;
+
+    /* Merging takes linear time, so merge when the recent symbols are a fixed fraction of all of them. */
+    if (recentEntries_.size() >= std::max(MIN_MERGE_SIZE, entries_.size() / 8)) {
+        merge();
+    }
+}
+
+boost::optional<uint32_t> SymbolTable::findOffset(ByteAddr addr) const {
+    auto i = std::lower_bound(entries_.begin(), entries_.end(), addr, AddrLess());
+    if (i != entries_.end() && i->addr == addr) {
+        return i->nameOffset;
+    }
+
+    auto j = recentEntries_.find(addr);
+    if (j != recentEntries_.end()) {
+        return j->second;
+    }
+
+    return boost::none;
+}
+
+QString SymbolTable::getName(ByteAddr addr) const {
+    if (auto nameOffset = findOffset(addr)) {
+        return QString::fromUtf8(&strings_[*nameOffset]);
+    }
+    return QString();
+}
+
+const char *SymbolTable::getUtf8Name(ByteAddr addr) const {
+    if (auto nameOffset = findOffset(addr)) {
+        return &strings_[*nameOffset];
+    }
+    return NULL;
+}
+
+boost::optional<ByteAddr> SymbolTable::getPrecedingAddress(ByteAddr addr) const {
+    boost::optional<ByteAddr> result;
+
+    auto i = std::upper_bound(entries_.begin(), entries_.end(), addr, AddrLess());
+    if (i != entries_.begin()) {
+        result = (i - 1)->addr;
+    }
+
+    auto j = recentEntries_.upper_bound(addr);
+    if (j != recentEntries_.begin()) {
+        --j;
+        if (!result || *result < j->first) {
+            result = j->first;
+        }
+    }
+
+    return result;
+}
+
+std::vector<ByteAddr> SymbolTable::getAddresses(ByteAddr begin, ByteAddr end) const {
+    std::vector<ByteAddr> result;
+
+    if (begin >= end) {
+        return result;
+    }
+
+    auto i = std::lower_bound(entries_.begin(), entries_.end(), begin, AddrLess());
+    auto iend = std::lower_bound(i, entries_.end(), end, AddrLess());
+    auto j = recentEntries_.lower_bound(begin);
+    auto jend = recentEntries_.lower_bound(end);
+
+    while (i != iend || j != jend) {
+        if (j == jend || (i != iend && i->addr < j->first)) {
+            result.push_back(i->addr);
+            ++i;
+        } else {
+            result.push_back(j->first);
+            ++j;
+        }
+    }
+
+    return result;
+}
+
+std::vector<ByteAddr> SymbolTable::addresses() const {
+    std::vector<ByteAddr> result;
+    result.reserve(size());
+
+    auto i = entries_.begin();
+    auto j = recentEntries_.begin();
+
+    while (i != entries_.end() || j != recentEntries_.end()) {
+        if (j == recentEntries_.end() || (i != entries_.end() && i->addr < j->first)) {
+            result.push_back(i->addr);
+            ++i;
+        } else {
+            result.push_back(j->first);
+            ++j;
+        }
+    }
+
+    return result;
+}
+
+uint32_t SymbolTable::intern(const QString &name) {
+    /* Keep the table at most half full, so that probe sequences stay short. */
+    if (2 * (namesCount_ + 1) > nameIndex_.size()) {
+        rehash(std::max(MIN_INDEX_SIZE, 2 * nameIndex_.size()));
+    }
+
+    QByteArray utf8 = name.toUtf8();
+
+    std::size_t mask = nameIndex_.size() - 1;
+    for (std::size_t i = hashName(utf8.constData()) & mask; ; i = (i + 1) & mask) {
+        if (uint32_t cell = nameIndex_[i]) {
+            if (strcmp(&strings_[cell - 1], utf8.constData()) == 0) {
+                return cell - 1;
+            }
+        } else {
+            /* Offsets are kept in 32 bits, shifted by one in the index. */
+            if (strings_.size() + utf8.size() + 1 >= std::numeric_limits<uint32_t>::max()) {
+                throw nc::Exception(QCoreApplication::translate("SymbolTable",
+                    "Symbol names take more than 4 GB of memory."));
+            }
+
+            uint32_t result = static_cast<uint32_t>(strings_.size());
+            strings_.insert(strings_.end(), utf8.constData(), utf8.constData() + utf8.size() + 1);
+            nameIndex_[i] = result + 1;
+            ++namesCount_;
+            return result;
+        }
+    }
+}
+
+void SymbolTable::rehash(std::size_t size) {
+    assert((size & (size - 1)) == 0 && size > namesCount_);
+
+    std::vector<uint32_t> nameIndex(size, 0);
+
+    std::size_t mask = size - 1;
+    foreach (uint32_t cell, nameIndex_) {
+        if (cell) {
+            std::size_t i = hashName(&strings_[cell - 1]) & mask;
+            while (nameIndex[i]) {
+                i = (i + 1) & mask;
+            }
+            nameIndex[i] = cell;
+        }
+    }
+
+    nameIndex_.swap(nameIndex);
+}
+
+void SymbolTable::merge() {
+    std::vector<Entry> entries;
+    entries.reserve(size());
+
+    auto i = entries_.begin();
+    auto j = recentEntries_.begin();
+
+    while (i != entries_.end() || j != recentEntries_.end()) {
+        if (j == recentEntries_.end() || (i != entries_.end() && i->addr < j->first)) {
+            entries.push_back(*i);
+            ++i;
+        } else {
+            entries.push_back(Entry(j->first, j->second));
+            ++j;
+        }
+    }
+
+    entries_.swap(entries);
+    recentEntries_.clear();
+}
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,170 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <QString>
+
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+
+/**
+ * Mapping from addresses to names, e.g. of the symbols of an executable.
+ *
+ * Names are stored once each in a pool of zero-terminated UTF-8 strings,
+ * found by an open-addressed hash table of their offsets. Addresses are
+ * kept in a sorted array, so that exact, nearest-preceding and range
+ * lookups take logarithmic time. Recently added symbols are kept
+ * aside in a small sorted map and merged into the array in batches.
+ *
+ * Lookups do not modify the table and can be done concurrently.
+ */
+class SymbolTable: boost::noncopyable {
+    /**
+     * Symbol: an address and the offset of its name in the string pool.
+     */
+    struct Entry {
+        ByteAddr addr; ///< Address.
+        uint32_t nameOffset; ///< Offset of the name in the string pool.
+
+        Entry(ByteAddr addr, uint32_t nameOffset): addr(addr), nameOffset(nameOffset) {}
+
+        bool operator<(const Entry &that) const { return addr < that.addr; }
+    };
+
+    std::vector<Entry> entries_; ///< Symbols sorted by address.
+    std::map<ByteAddr, uint32_t> recentEntries_; ///< Symbols not yet merged into entries_, at addresses absent from it.
+    std::vector<char> strings_; ///< Pool of zero-terminated UTF-8 names.
+    std::vector<uint32_t> nameIndex_; ///< Hash table of the offsets of the names in the pool plus one, with linear probing. Zero marks a free cell.
+    std::size_t namesCount_; ///< Number of distinct names in the pool.
+
+    public:
+
+    /**
+     * Constructor.
+     */
+    SymbolTable();
+
+    /**
+     * Destructor.
+     */
+    ~SymbolTable();
+
+    /**
+     * \return Number of symbols in the table.
+     */
+    std::size_t size() const { return entries_.size() + recentEntries_.size(); }
+
+    /**
+     * Sets the name of an address, replacing the previous one, if any.
+     * Empty names are ignored.
+     *
+     * \param addr Address.
+     * \param name Name.
+     */
+    void add(ByteAddr addr, const QString &name);
+
+    /**
+     * \param addr Address.
+     *
+     * \return True if the address has a name.
+     */
+    bool contains(ByteAddr addr) const { return findOffset(addr) != boost::none; }
+
+    /**
+     * \param addr Address.
+     *
+     * \return Name of the address, if any, and QString() otherwise.
+     */
+    QString getName(ByteAddr addr) const;
+
+    /**
+     * \param addr Address.
+     *
+     * \return Pointer to the zero-terminated UTF-8 name of the address, if any,
+     *         and NULL otherwise. Unlike getName(), does not decode or copy the name.
+     *         The pointer is valid until the next call to add().
+     */
+    const char *getUtf8Name(ByteAddr addr) const;
+
+    /**
+     * \param addr Address.
+     *
+     * \return The greatest address not exceeding the given one that has a name, if any.
+     */
+    boost::optional<ByteAddr> getPrecedingAddress(ByteAddr addr) const;
+
+    /**
+     * \param begin First address of the range.
+     * \param end Address following the last address of the range.
+     *
+     * \return Sorted list of the addresses in [begin, end) having names.
+     */
+    std::vector<ByteAddr> getAddresses(ByteAddr begin, ByteAddr end) const;
+
+    /**
+     * \return Sorted list of all the addresses having names.
+     */
+    std::vector<ByteAddr> addresses() const;
+
+    private:
+
+    /**
+     * \param addr Address.
+     *
+     * \return Offset of the name of the address in the string pool, if the address has a name.
+     */
+    boost::optional<uint32_t> findOffset(ByteAddr addr) const;
+
+    /**
+     * \param name Name.
+     *
+     * \return Offset of the name in the string pool. The name is added to the pool if it is not there yet.
+     */
+    uint32_t intern(const QString &name);
+
+    /**
+     * Rebuilds the hash table of names with the given number of cells.
+     *
+     * \param size Number of cells, a power of two greater than the number of names.
+     */
+    void rehash(std::size_t size);
+
+    /**
+     * Merges the recently added symbols into the sorted array.
+     */
+    void merge();
+};
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -26,11 +26,14 @@
 #include <cstdint> /* uintptr_t */
 
 #include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
 
 #include <nc/core/Context.h>
 #include <nc/core/Module.h>
 #include <nc/core/arch/irgen/IRGenerator.h>
 #include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/CFG.h>
+#include <nc/core/ir/DominatorTree.h>
 #include <nc/core/ir/Function.h>
 #include <nc/core/ir/Functions.h>
 #include <nc/core/ir/FunctionsGenerator.h>
@@ -43,6 +46,7 @@
 #include <nc/core/ir/cgen/CodeGenerator.h>
 #include <nc/core/ir/dflow/Dataflow.h>
 #include <nc/core/ir/dflow/DataflowAnalyzer.h>
+#include <nc/core/ir/misc/CallGraph.h>
 #include <nc/core/ir/misc/TermToFunction.h>
 #include <nc/core/ir/types/TypeAnalyzer.h>
 #include <nc/core/ir/types/Types.h>
@@ -89,29 +93,63 @@ void UniversalAnalyzer::decompile(Context *context) const {
         computeTermToFunctionMapping(context);
         checkForCancellation();
 
-        foreach (const ir::Function *function, context->functions()->functions()) {
-            context->logToken() << QObject::tr("Running dataflow analysis on %1...").arg(function->name());
-            analyzeDataflow(context, function);
+        /*
+         * Dataflow analysis is run bottom-up on the call graph, so that
+         * callees are analyzed before their callers. Strongly connected
+         * components of the same level do not call each other and are
+         * processed concurrently.
+         */
+        context->logToken() << QObject::tr("Building the call graph...");
+        ir::misc::CallGraph callGraph(context->functions(), context->callsData());
+        checkForCancellation();
+
+        foreach (const auto &level, callGraph.levels()) {
+            parallelForEach(level, context->threadCount(), [&](const ir::misc::CallGraph::Component *component) {
+                foreach (const ir::Function *function, *component) {
+                    if (context->cancellationToken()) {
+                        return;
+                    }
+
+                    createCfg(context, function);
+
+                    context->logToken() << QObject::tr("Running dataflow analysis on %1...").arg(function->name());
+                    analyzeDataflow(context, function);
+                }
+            });
             checkForCancellation();
         }
 
-        foreach (const ir::Function *function, context->functions()->functions()) {
+        /*
+         * The results of the following analyses are stored per function,
+         * therefore, different functions can be processed concurrently.
+         */
+        parallelForEach(context->functions()->functions(), context->threadCount(), [&](const ir::Function *function) {
+            if (context->cancellationToken()) {
+                return;
+            }
+
             context->logToken() << QObject::tr("Running structural analysis on %1...").arg(function->name());
             doStructuralAnalysis(context, function);
-            checkForCancellation();
+            if (context->cancellationToken()) {
+                return;
+            }
 
             context->logToken() << QObject::tr("Running liveness analysis on %1...").arg(function->name());
             computeUsage(context, function);
-            checkForCancellation();
+            if (context->cancellationToken()) {
+                return;
+            }
 
             context->logToken() << QObject::tr("Running type reconstruction on %1...").arg(function->name());
             reconstructTypes(context, function);
-            checkForCancellation();
+            if (context->cancellationToken()) {
+                return;
+            }
 
             context->logToken() << QObject::tr("Running reconstruction of variables on %1...").arg(function->name());
             reconstructVariables(context, function);
-            checkForCancellation();
-        }
+        });
+        checkForCancellation();
 
         context->logToken() << QObject::tr("Generating AST...");
         generateTree(context);
@@ -139,6 +177,7 @@ void UniversalAnalyzer::createProgram(Context *context) const {
 void UniversalAnalyzer::createFunctions(Context *context) const {
     std::unique_ptr<ir::Functions> functions(new ir::Functions);
     ir::FunctionsGenerator generator;
+    generator.setStubs(&context->module()->stubs());
     generator.makeFunctions(*context->program(), *functions);
 
     foreach (ir::Function *function, functions->functions()) {
@@ -180,6 +219,10 @@ void UniversalAnalyzer::pickFunctionName(Context *context, ir::Function *functio
 void UniversalAnalyzer::createCallsData(Context *context) const {
     std::unique_ptr<ir::calls::CallsData> callsData(new ir::calls::CallsData());
 
+    foreach (const auto &pair, context->module()->stubs()) {
+        callsData->setStubSlot(pair.first, pair.second);
+    }
+
     class Detector: public ir::calls::CallingConventionDetector {
         const UniversalAnalyzer *universalAnalyzer_;
         Context *context_;
@@ -215,11 +258,19 @@ void UniversalAnalyzer::analyzeDataflow(Context *context, const ir::Function *fu
     std::unique_ptr<ir::dflow::Dataflow> dataflow(new ir::dflow::Dataflow());
 
     ir::dflow::DataflowAnalyzer analyzer(*dataflow, context->module()->architecture(), context->callsData());
-    analyzer.analyze(function, context->cancellationToken());
+    if (context->sparseDataflow()) {
+        analyzer.analyzeSparsely(function, *context->getCfg(function), *context->getDominatorTree(function), context->cancellationToken());
+    } else {
+        analyzer.analyze(function, *context->getCfg(function), context->cancellationToken());
+    }
 
     context->setDataflow(function, std::move(dataflow));
 }
 
+void UniversalAnalyzer::createCfg(Context *context, const ir::Function *function) const {
+    context->setCfg(function, std::unique_ptr<ir::CFG>(new ir::CFG(function->basicBlocks())));
+}
+
 void UniversalAnalyzer::computeUsage(Context *context, const ir::Function *function) const {
     std::unique_ptr<ir::usage::Usage> usage(new ir::usage::Usage());
 
@@ -252,7 +303,7 @@ void UniversalAnalyzer::reconstructVariables(Context *context, const ir::Functio
 void UniversalAnalyzer::doStructuralAnalysis(Context *context, const ir::Function *function) const {
     std::unique_ptr<ir::cflow::Graph> graph(new ir::cflow::Graph());
 
-    ir::cflow::GraphBuilder()(*graph, function);
+    ir::cflow::GraphBuilder()(*graph, function, *context->getCfg(function));
     ir::cflow::StructureAnalyzer(*graph, *context->getDataflow(function)).analyze();
 
     context->setRegionGraph(function, std::move(graph));
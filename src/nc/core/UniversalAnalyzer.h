@@ -51,8 +51,13 @@ class Context;
  * and register it by calling Architecture::setUniversalAnalyzer().
  * 
  * Methods of this class can be executed concurrently.
- * (Though, only on different context currently.)
  * Therefore, they all are const.
+ * In particular, decompile() runs createCfg(), analyzeDataflow(),
+ * doStructuralAnalysis(), computeUsage(), reconstructTypes(), and
+ * reconstructVariables() for different functions in up to
+ * Context::threadCount() threads. These methods must only touch the
+ * results of the function they are called for, and access the calls
+ * data only through its thread-safe interface.
  */
 class UniversalAnalyzer {
     public:
@@ -114,6 +119,15 @@ class UniversalAnalyzer {
      */
     virtual void computeTermToFunctionMapping(Context *context) const;
 
+    /**
+     * Builds the control flow graph of a function and stores it in the context.
+     * The graph is then used by the analyses of the function.
+     *
+     * \param context Valid pointer to the context.
+     * \param function Valid pointer to the function.
+     */
+    virtual void createCfg(Context *context, const ir::Function *function) const;
+
     /**
      * Analyzes the dataflow of a function.
      *
@@ -23,6 +23,10 @@
 
 #include <boost/range/adaptor/map.hpp>
 
+#ifdef NC_USE_THREADS
+#include <QMutexLocker>
+#endif
+
 #include <nc/common/BitTwiddling.h>
 #include <nc/common/Foreach.h>
 
@@ -106,6 +110,11 @@ void Architecture::initRegisters(Registers *registers) {
 }
 
 Architecture::~Architecture() {
+    /* Parents first: their destructors look at their children. */
+    for (std::size_t i = mCompoundOperands.size(); i > 0; --i) {
+        delete mCompoundOperands[i - 1];
+    }
+
     foreach(Operand *operand, mConstantOperands | boost::adaptors::map_values) {
         delete operand;
     }
@@ -141,6 +150,10 @@ void Architecture::addRegisterOperand(const Register *regizter) {
 }
 
 ConstantOperand *Architecture::constantOperand(const SizedValue &value) const {
+#ifdef NC_USE_THREADS
+    QMutexLocker locker(&mOperandsMutex);
+#endif
+
     auto &result = mConstantOperands[std::make_pair(value.value(), value.size())];
     if (!result) {
         result = new ConstantOperand(value);
@@ -148,6 +161,72 @@ ConstantOperand *Architecture::constantOperand(const SizedValue &value) const {
     return result;
 }
 
+AdditionOperand *Architecture::additionOperand(Operand *left, Operand *right, SmallBitSize size) const {
+    assert(left != NULL && left->isCached());
+    assert(right != NULL && right->isCached());
+
+#ifdef NC_USE_THREADS
+    QMutexLocker locker(&mOperandsMutex);
+#endif
+
+    auto &result = mAdditionOperands[std::make_pair(std::make_pair(left, right), size)];
+    if (!result) {
+        result = new AdditionOperand(left, right, size);
+        result->setCached(true);
+        mCompoundOperands.push_back(result);
+    }
+    return result;
+}
+
+MultiplicationOperand *Architecture::multiplicationOperand(Operand *left, Operand *right, SmallBitSize size) const {
+    assert(left != NULL && left->isCached());
+    assert(right != NULL && right->isCached());
+
+#ifdef NC_USE_THREADS
+    QMutexLocker locker(&mOperandsMutex);
+#endif
+
+    auto &result = mMultiplicationOperands[std::make_pair(std::make_pair(left, right), size)];
+    if (!result) {
+        result = new MultiplicationOperand(left, right, size);
+        result->setCached(true);
+        mCompoundOperands.push_back(result);
+    }
+    return result;
+}
+
+DereferenceOperand *Architecture::dereferenceOperand(Operand *operand, SmallBitSize size) const {
+    assert(operand != NULL && operand->isCached());
+
+#ifdef NC_USE_THREADS
+    QMutexLocker locker(&mOperandsMutex);
+#endif
+
+    auto &result = mDereferenceOperands[std::make_pair(operand, size)];
+    if (!result) {
+        result = new DereferenceOperand(operand, size);
+        result->setCached(true);
+        mCompoundOperands.push_back(result);
+    }
+    return result;
+}
+
+BitRangeOperand *Architecture::bitRangeOperand(Operand *operand, SmallBitOffset offset, SmallBitSize size) const {
+    assert(operand != NULL && operand->isCached());
+
+#ifdef NC_USE_THREADS
+    QMutexLocker locker(&mOperandsMutex);
+#endif
+
+    auto &result = mBitRangeOperands[std::make_pair(std::make_pair(operand, offset), size)];
+    if (!result) {
+        result = new BitRangeOperand(operand, offset, size);
+        result->setCached(true);
+        mCompoundOperands.push_back(result);
+    }
+    return result;
+}
+
 bool Architecture::isGlobalMemory(const ir::MemoryLocation &memoryLocation) const {
     return memoryLocation.domain() == ir::MemoryDomain::MEMORY;
 }
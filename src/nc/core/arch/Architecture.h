@@ -27,6 +27,10 @@
 
 #include <boost/unordered_map.hpp>
 
+#ifdef NC_USE_THREADS
+#include <QMutex>
+#endif
+
 #include <nc/common/SizedValue.h>
 #include <nc/common/Types.h>
 #include <nc/core/ir/MemoryLocation.h>
@@ -46,8 +50,13 @@ namespace irgen {
     class InstructionAnalyzer;
 }
 
+class AdditionOperand;
+class BitRangeOperand;
 class ConstantOperand;
+class DereferenceOperand;
 class Mnemonics;
+class MultiplicationOperand;
+class Operand;
 class Register;
 class RegisterOperand;
 class Registers;
@@ -121,6 +130,37 @@ public:
      */
     ConstantOperand *constantOperand(const SizedValue &value) const;
 
+    /**
+     * \param left                     Valid pointer to a cached left summand.
+     * \param right                    Valid pointer to a cached right summand.
+     * \param size                     Size of the sum in bits.
+     * \returns                        Cached operand for the sum.
+     */
+    AdditionOperand *additionOperand(Operand *left, Operand *right, SmallBitSize size) const;
+
+    /**
+     * \param left                     Valid pointer to a cached left multiplier.
+     * \param right                    Valid pointer to a cached right multiplier.
+     * \param size                     Size of the product in bits.
+     * \returns                        Cached operand for the product.
+     */
+    MultiplicationOperand *multiplicationOperand(Operand *left, Operand *right, SmallBitSize size) const;
+
+    /**
+     * \param operand                  Valid pointer to a cached operand computing the address.
+     * \param size                     Size of the memory access in bits.
+     * \returns                        Cached operand for the dereference.
+     */
+    DereferenceOperand *dereferenceOperand(Operand *operand, SmallBitSize size) const;
+
+    /**
+     * \param operand                  Valid pointer to a cached operand.
+     * \param offset                   Offset of the bit range in bits.
+     * \param size                     Size of the bit range in bits.
+     * \returns                        Cached operand for the bit range.
+     */
+    BitRangeOperand *bitRangeOperand(Operand *operand, SmallBitOffset offset, SmallBitSize size) const;
+
     /**
      * \return                         Pointer to instruction pointer register. Can be NULL.
      */
@@ -213,6 +253,26 @@ private:
 
     /** Cached constant operands. */
     mutable boost::unordered_map<std::pair<ConstantValue, SmallBitSize>, ConstantOperand *> mConstantOperands;
+
+    /** Cached addition operands. */
+    mutable boost::unordered_map<std::pair<std::pair<const Operand *, const Operand *>, SmallBitSize>, AdditionOperand *> mAdditionOperands;
+
+    /** Cached multiplication operands. */
+    mutable boost::unordered_map<std::pair<std::pair<const Operand *, const Operand *>, SmallBitSize>, MultiplicationOperand *> mMultiplicationOperands;
+
+    /** Cached dereference operands. */
+    mutable boost::unordered_map<std::pair<const Operand *, SmallBitSize>, DereferenceOperand *> mDereferenceOperands;
+
+    /** Cached bit range operands. */
+    mutable boost::unordered_map<std::pair<std::pair<const Operand *, SmallBitOffset>, SmallBitSize>, BitRangeOperand *> mBitRangeOperands;
+
+    /** Cached compound operands in the order of creation: operands always go after their children. */
+    mutable std::vector<Operand *> mCompoundOperands;
+
+#ifdef NC_USE_THREADS
+    /** Mutex guarding the caches of constant and compound operands. */
+    mutable QMutex mOperandsMutex;
+#endif
 };
 
 } // namespace arch
@@ -21,10 +21,11 @@
 
 #include "Instruction.h"
 
+#include <algorithm> /* std::copy(), std::copy_backward() */
+
 #include <QTextStream>
 
-#include <nc/common/Visitor.h>
-#include <nc/common/Foreach.h>
+#include <nc/common/ObjectPool.h>
 
 #include "Operand.h"
 
@@ -32,23 +33,68 @@ namespace nc {
 namespace core {
 namespace arch {
 
+namespace {
+
+/** Pool the instructions are allocated from. */
+ObjectPool *const instructionPool = new ObjectPool();
+
+} // anonymous namespace
+
+void *Instruction::operator new(std::size_t size) {
+    return instructionPool->allocate(size);
+}
+
+void Instruction::operator delete(void *pointer, std::size_t size) {
+    instructionPool->deallocate(pointer, size);
+}
+
 Instruction::~Instruction() {
     clearOperands();
+
+    if (operands_ != inlineOperands_) {
+        delete[] operands_;
+    }
+}
+
+void Instruction::addOperand(std::size_t index, Operand *operand) {
+    assert(operand != NULL);
+    assert(index <= operandCount_);
+
+    if (operandCount_ == operandCapacity_) {
+        Operand **operands = new Operand *[operandCapacity_ * 2];
+        std::copy(operands_, operands_ + operandCount_, operands);
+
+        if (operands_ != inlineOperands_) {
+            delete[] operands_;
+        }
+        operands_ = operands;
+        operandCapacity_ *= 2;
+    }
+
+    std::copy_backward(operands_ + index, operands_ + operandCount_, operands_ + operandCount_ + 1);
+    operands_[index] = operand;
+    ++operandCount_;
 }
 
 void Instruction::clearOperands() {
-    foreach(Operand *operand, operands_) {
-        operand->dispose();
+    for (unsigned i = 0; i < operandCount_; ++i) {
+        operands_[i]->dispose();
     }
-    operands_.clear();
+    operandCount_ = 0;
 }
 
 void Instruction::removeOperand(std::size_t index) {
+    assert(index < operandCount_);
+
     operands_[index]->dispose();
-    operands_.erase(operands_.begin() + index);
+    std::copy(operands_ + index + 1, operands_ + operandCount_, operands_ + index);
+    --operandCount_;
 }
 
 void Instruction::replaceOperand(std::size_t index, Operand *operand) {
+    assert(index < operandCount_);
+    assert(operand != NULL);
+
     operands_[index]->dispose();
     operands_[index] = operand;
 }
@@ -23,7 +23,10 @@
 #include <nc/config.h>
 
 #include <cassert>
-#include <vector>
+#include <cstddef> /* std::size_t */
+
+#include <boost/noncopyable.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <QString>
 
@@ -42,7 +45,7 @@ class Mnemonic;
 /**
  * Base class for instructions.
  */
-class Instruction: public Printable {
+class Instruction: public Printable, boost::noncopyable {
     /** Mnemonic of this instruction. */
     const Mnemonic *mnemonic_;
 
@@ -52,8 +55,20 @@ class Instruction: public Printable {
     /** Instruction's size in bytes. */
     SmallByteSize size_;
 
-    /** Instruction's operands. */
-    std::vector<Operand *> operands_;
+    /** Number of operands. */
+    unsigned operandCount_;
+
+    /** Number of operands the operands_ array can hold. */
+    unsigned operandCapacity_;
+
+    /** Instruction's operands: either inlineOperands_, or a heap array, if they do not fit. */
+    Operand **operands_;
+
+    /** Number of operands stored without a heap allocation. */
+    static const unsigned INLINE_OPERAND_COUNT = 3;
+
+    /** Inline storage for the operands. */
+    Operand *inlineOperands_[INLINE_OPERAND_COUNT];
 
 public:
     /**
@@ -64,7 +79,8 @@ public:
      * \param[in] size      Instruction's size in bytes.
      */
     Instruction(const Mnemonic *mnemonic, ByteAddr addr = 0, SmallByteSize size = 0):
-        mnemonic_(mnemonic), addr_(addr), size_(size)
+        mnemonic_(mnemonic), addr_(addr), size_(size),
+        operandCount_(0), operandCapacity_(INLINE_OPERAND_COUNT), operands_(inlineOperands_)
     {
         assert(mnemonic != NULL);
         assert(size >= 0);
@@ -75,6 +91,24 @@ public:
      */
     virtual ~Instruction();
 
+    /**
+     * Allocates memory for an instruction from the pool shared by all instructions.
+     * Instructions disassembled one after another end up next to each other in memory.
+     *
+     * \param size Size of the object.
+     *
+     * \return Valid pointer to the memory.
+     */
+    static void *operator new(std::size_t size);
+
+    /**
+     * Returns the memory of an instruction to the pool.
+     *
+     * \param pointer Pointer to the memory. Can be NULL.
+     * \param size Size of the object.
+     */
+    static void operator delete(void *pointer, std::size_t size);
+
     /**
      * \return Valid pointer to the mnemonic of this instruction.
      */
@@ -90,8 +124,9 @@ public:
     /**
      * \return Instruction's operands.
      */
-    const std::vector<const Operand *> &operands() const {
-        return reinterpret_cast<const std::vector<const Operand *> &>(operands_);
+    boost::iterator_range<const Operand *const *> operands() const {
+        const Operand *const *begin = const_cast<const Operand *const *>(operands_);
+        return boost::iterator_range<const Operand *const *>(begin, begin + operandCount_);
     }
 
     /**
@@ -99,29 +134,23 @@ public:
      *
      * \return Operand for the given index.
      */
-    const Operand *operand(std::size_t index) const { assert(index < operands_.size()); return operands_[index]; }
+    const Operand *operand(std::size_t index) const { assert(index < operandCount_); return operands_[index]; }
 
     /**
      * Adds the given operand to the list of operands for this instruction.
-     * 
+     *
      * \param[in] operand Valid pointer to the operand to add.
      */
-    void addOperand(Operand *operand) {
-        assert(operand != NULL);
-        operands_.push_back(operand);
-    }
+    void addOperand(Operand *operand) { addOperand(operandCount_, operand); }
 
     /**
      * Inserts the given operand into the list of operands for this instruction
      * at given position.
-     * 
+     *
      * \param[in] index                Position to insert operand at.
      * \param[in] operand              Operand to insert.
      */
-    void addOperand(std::size_t index, Operand *operand) {
-        assert(operand != NULL);
-        operands_.insert(operands_.begin() + index, operand);
-    }
+    void addOperand(std::size_t index, Operand *operand);
 
     /**
      * Removes operand at given position.
@@ -21,6 +21,8 @@
 
 #include "Instructions.h"
 
+#include <algorithm> /* std::lower_bound() */
+
 #include <QTextStream>
 
 #include <nc/common/Foreach.h>
@@ -29,37 +31,147 @@ namespace nc {
 namespace core {
 namespace arch {
 
-const std::shared_ptr<const Instruction> &Instructions::getCovering(ByteAddr addr) const {
-    auto i = address2instruction_.lower_bound(addr);
+namespace {
+
+/**
+ * Maximal number of instructions in a chunk.
+ */
+const std::size_t MAX_CHUNK_SIZE = 1024;
+
+bool addrLess(const std::shared_ptr<const Instruction> &instruction, ByteAddr addr) {
+    return instruction->addr() < addr;
+}
+
+const std::shared_ptr<const Instruction> &null() {
+    static const std::shared_ptr<const Instruction> result;
+    return result;
+}
+
+} // anonymous namespace
+
+std::size_t Instructions::findChunk(ByteAddr addr) const {
+    std::size_t begin = 0;
+    std::size_t end = chunks_.size();
+
+    /* Find the first chunk starting after the address. */
+    while (begin < end) {
+        std::size_t middle = begin + (end - begin) / 2;
+        if (chunks_[middle]->front()->addr() <= addr) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
 
-    if (i != address2instruction_.end() &&
-        i->second->addr() <= addr && addr < i->second->endAddr())
-    {
-        return i->second;
+    return begin > 0 ? begin - 1 : 0;
+}
+
+Instructions::Chunk &Instructions::modifiableChunk(std::size_t index) {
+    assert(index < chunks_.size());
+
+    std::shared_ptr<Chunk> &chunk = chunks_[index];
+    if (!chunk.unique()) {
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+    return *chunk;
+}
+
+const std::shared_ptr<const Instruction> &Instructions::get(ByteAddr addr) const {
+    if (chunks_.empty()) {
+        return null();
+    }
+
+    const Chunk &chunk = *chunks_[findChunk(addr)];
+
+    auto i = std::lower_bound(chunk.begin(), chunk.end(), addr, addrLess);
+    if (i != chunk.end() && (*i)->addr() == addr) {
+        return *i;
     } else {
-        static const std::shared_ptr<const Instruction> null;
-        return null;
+        return null();
+    }
+}
+
+const std::shared_ptr<const Instruction> &Instructions::getCovering(ByteAddr addr) const {
+    if (chunks_.empty()) {
+        return null();
+    }
+
+    const Chunk &chunk = *chunks_[findChunk(addr)];
+
+    /* The last instruction starting not after the address. */
+    auto i = std::lower_bound(chunk.begin(), chunk.end(), addr + 1, addrLess);
+    if (i != chunk.begin()) {
+        --i;
+        if ((*i)->addr() <= addr && addr < (*i)->endAddr()) {
+            return *i;
+        }
     }
+
+    return null();
 }
 
 bool Instructions::add(const std::shared_ptr<const Instruction> &instruction) {
     assert(instruction != NULL);
 
-    auto &existing = address2instruction_[instruction->addr()];
-    if (!existing) {
-        existing = instruction;
+    if (chunks_.empty()) {
+        chunks_.push_back(std::make_shared<Chunk>(1, instruction));
+        ++size_;
         return true;
-    } else {
+    }
+
+    std::size_t chunkIndex = findChunk(instruction->addr());
+
+    const Chunk &chunk = *chunks_[chunkIndex];
+    auto i = std::lower_bound(chunk.begin(), chunk.end(), instruction->addr(), addrLess);
+    if (i != chunk.end() && (*i)->addr() == instruction->addr()) {
         return false;
     }
+    std::size_t index = i - chunk.begin();
+
+    if (chunk.size() < MAX_CHUNK_SIZE) {
+        Chunk &modifiable = modifiableChunk(chunkIndex);
+        modifiable.insert(modifiable.begin() + index, instruction);
+    } else if (index == chunk.size()) {
+        /* Appending to a full chunk: start a new one, as instructions are mostly added in order. */
+        chunks_.insert(chunks_.begin() + chunkIndex + 1, std::make_shared<Chunk>(1, instruction));
+    } else {
+        /* Split the full chunk in two halves. */
+        std::size_t half = chunk.size() / 2;
+
+        auto first = std::make_shared<Chunk>(chunk.begin(), chunk.begin() + half);
+        auto second = std::make_shared<Chunk>(chunk.begin() + half, chunk.end());
+
+        if (index <= half) {
+            first->insert(first->begin() + index, instruction);
+        } else {
+            second->insert(second->begin() + (index - half), instruction);
+        }
+
+        chunks_[chunkIndex] = first;
+        chunks_.insert(chunks_.begin() + chunkIndex + 1, second);
+    }
+
+    ++size_;
+    return true;
 }
 
 bool Instructions::remove(const Instruction *instruction) {
-    if (get(instruction->addr()).get() == instruction) {
-        return address2instruction_.erase(instruction->addr());
-    } else {
+    assert(instruction != NULL);
+
+    if (get(instruction->addr()).get() != instruction) {
         return false;
     }
+
+    std::size_t chunkIndex = findChunk(instruction->addr());
+    Chunk &chunk = modifiableChunk(chunkIndex);
+
+    chunk.erase(std::lower_bound(chunk.begin(), chunk.end(), instruction->addr(), addrLess));
+    if (chunk.empty()) {
+        chunks_.erase(chunks_.begin() + chunkIndex);
+    }
+
+    --size_;
+    return true;
 }
 
 void Instructions::print(QTextStream &out, PrintCallback<const Instruction> *callback) const {
@@ -22,13 +22,14 @@
 
 #include <nc/config.h>
 
-#include <map>
+#include <cstddef> /* std::size_t */
 #include <memory> /* std::shared_ptr */
+#include <vector>
 
-#include <boost/range/adaptor/map.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <nc/common/PrintCallback.h>
-#include <nc/common/Range.h> /* nc::find */
 
 #include "Instruction.h"
 
@@ -38,23 +39,73 @@ class Instruction;
 
 /**
  * Class representing a set of instructions.
+ *
+ * Instructions are kept in a sequence of sorted chunks of limited size.
+ * Copies of a set share the chunks, and a chunk is copied only when it is
+ * changed in a set sharing it. Therefore, copying a set and changing a few
+ * instructions in the copy takes time proportional to the number of chunks,
+ * not to the number of instructions.
  */
 class Instructions {
-    /** Type of mapping of addresses to instruction. */
-    typedef std::map<ByteAddr, std::shared_ptr<const Instruction>> AddressInstructionMap;
+    /** Chunk of instructions sorted by their addresses. */
+    typedef std::vector<std::shared_ptr<const Instruction>> Chunk;
+
+    /** Non-empty chunks sorted by the addresses of their instructions. */
+    std::vector<std::shared_ptr<Chunk>> chunks_;
 
-    /** Mapping of addresses to instructions. */
-    AddressInstructionMap address2instruction_;
+    /** Number of instructions in the set. */
+    std::size_t size_;
 
     public:
 
+    /**
+     * Iterator over the instructions sorted by their addresses.
+     */
+    class ConstIterator: public boost::iterator_facade<
+        ConstIterator, const std::shared_ptr<const Instruction>, boost::forward_traversal_tag>
+    {
+        const std::vector<std::shared_ptr<Chunk>> *chunks_; ///< Chunks of the set.
+        std::size_t chunkIndex_; ///< Index of the current chunk.
+        std::size_t index_; ///< Index of the current instruction in the chunk.
+
+        public:
+
+        ConstIterator(): chunks_(NULL), chunkIndex_(0), index_(0) {}
+
+        ConstIterator(const std::vector<std::shared_ptr<Chunk>> *chunks, std::size_t chunkIndex, std::size_t index):
+            chunks_(chunks), chunkIndex_(chunkIndex), index_(index)
+        {}
+
+        private:
+
+        friend class boost::iterator_core_access;
+
+        const std::shared_ptr<const Instruction> &dereference() const { return (*(*chunks_)[chunkIndex_])[index_]; }
+
+        bool equal(const ConstIterator &that) const { return chunkIndex_ == that.chunkIndex_ && index_ == that.index_; }
+
+        void increment() {
+            if (++index_ == (*chunks_)[chunkIndex_]->size()) {
+                ++chunkIndex_;
+                index_ = 0;
+            }
+        }
+    };
+
     /** Type for the sorted range of instructions. */
-    typedef boost::select_second_const_range<AddressInstructionMap> InstructionsRange;
+    typedef boost::iterator_range<ConstIterator> InstructionsRange;
+
+    /**
+     * Constructs an empty set.
+     */
+    Instructions(): size_(0) {}
 
     /**
      * \return Range of instructions sorted by their addresses in ascending order.
      */
-    InstructionsRange all() const { return address2instruction_ | boost::adaptors::map_values; }
+    InstructionsRange all() const {
+        return InstructionsRange(ConstIterator(&chunks_, 0, 0), ConstIterator(&chunks_, chunks_.size(), 0));
+    }
 
     /**
      * \param[in] addr Address.
@@ -62,7 +113,7 @@ class Instructions {
      * \return Pointer to the instruction starting at the given address.
      *         Can be NULL, if there is no such instructions.
      */
-    const std::shared_ptr<const Instruction> &get(ByteAddr addr) const { return nc::find(address2instruction_, addr); }
+    const std::shared_ptr<const Instruction> &get(ByteAddr addr) const;
 
     /**
      * \param[in] addr Address.
@@ -93,7 +144,7 @@ class Instructions {
     /**
      * \return Number of instructions in the set.
      */
-    std::size_t size() const { return address2instruction_.size(); }
+    std::size_t size() const { return size_; }
 
     /**
      * \return True if the set is empty, false is otherwise.
@@ -107,6 +158,24 @@ class Instructions {
      * \param callback Pointer to the print callback. Can be NULL.
      */
     void print(QTextStream &out, PrintCallback<const Instruction> *callback = NULL) const;
+
+    private:
+
+    /**
+     * \param[in] addr Address.
+     *
+     * \return Index of the last chunk whose first instruction starts
+     *         not after the given address, or 0 if there is no such chunk.
+     */
+    std::size_t findChunk(ByteAddr addr) const;
+
+    /**
+     * \param[in] index Index of a chunk.
+     *
+     * \return The chunk with the given index, copied beforehand
+     *         if it is shared with another set.
+     */
+    Chunk &modifiableChunk(std::size_t index);
 };
 
 }}} // namespace nc::core::arch
@@ -21,14 +21,17 @@
 
 #include "Disassembler.h"
 
-#include <algorithm> /* std::max() */
+#include <algorithm> /* std::max(), std::lower_bound() */
 #include <memory>
+#include <vector>
 
 #include <nc/core/arch/Architecture.h>
 #include <nc/core/arch/Instructions.h>
 #include <nc/core/image/ByteSource.h>
 
 #include <nc/common/CancellationToken.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
 #include <nc/common/Warnings.h>
 
 #include "InstructionDisassembler.h"
@@ -38,41 +41,183 @@ namespace core {
 namespace arch {
 namespace disasm {
 
+namespace {
+
+/**
+ * Minimal size of a chunk decoded by a single thread.
+ */
+const ByteSize MIN_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Disassembler of a chunk of a range of addresses, using its own
+ * instruction disassembler and collecting the instructions into a vector.
+ */
+class ChunkDisassembler: public Disassembler {
+    std::unique_ptr<InstructionDisassembler> instructionDisassembler_; ///< Instruction disassembler.
+    ByteAddr begin_; ///< First address of the chunk.
+    ByteAddr end_; ///< First address past the chunk.
+    ByteAddr stop_; ///< Address where the decoding stopped.
+    std::vector<std::unique_ptr<Instruction>> result_; ///< Decoded instructions, sorted by address.
+
+    public:
+
+    ChunkDisassembler(Architecture *architecture, std::unique_ptr<InstructionDisassembler> instructionDisassembler,
+                      ByteAddr begin, ByteAddr end):
+        Disassembler(architecture, NULL),
+        instructionDisassembler_(std::move(instructionDisassembler)),
+        begin_(begin), end_(end), stop_(begin)
+    {
+        assert(instructionDisassembler_);
+    }
+
+    ByteAddr begin() const { return begin_; }
+    ByteAddr end() const { return end_; }
+    ByteAddr stop() const { return stop_; }
+    std::vector<std::unique_ptr<Instruction>> &result() { return result_; }
+
+    /**
+     * Decodes the chunk.
+     *
+     * \param source Valid pointer to a byte source.
+     * \param limit First address past the readable bytes.
+     * \param canceled Cancellation token.
+     */
+    void run(const image::ByteSource *source, ByteAddr limit, const CancellationToken &canceled) {
+        stop_ = disassembleRange(source, begin_, end_, limit, canceled);
+    }
+
+    protected:
+
+    std::unique_ptr<Instruction> disassembleInstruction(ByteAddr pc, const void *buffer, SmallByteSize size) override {
+        return instructionDisassembler_->disassemble(pc, buffer, size);
+    }
+
+    void addInstruction(std::unique_ptr<Instruction> instruction) override {
+        result_.push_back(std::move(instruction));
+    }
+};
+
+bool addrLess(const std::unique_ptr<Instruction> &instruction, ByteAddr addr) {
+    return instruction->addr() < addr;
+}
+
+} // anonymous namespace
+
 void Disassembler::disassemble(const image::ByteSource *source, ByteAddr begin, ByteAddr end, const CancellationToken &canceled) {
+    disassembleRange(source, begin, end, end, canceled);
+}
+
+void Disassembler::disassembleInParallel(const image::ByteSource *source, ByteAddr begin, ByteAddr end, int threadCount, const CancellationToken &canceled) {
     assert(source != NULL);
 
+    if (threadCount < 2 || end - begin < 2 * MIN_CHUNK_SIZE || !architecture()->instructionDisassembler()) {
+        disassemble(source, begin, end, canceled);
+        return;
+    }
+
+    /* A few chunks per thread for a better load balance. */
+    ByteSize chunkSize = std::max(MIN_CHUNK_SIZE, (end - begin) / (4 * threadCount) + 1);
+
+    std::vector<std::unique_ptr<ChunkDisassembler>> chunks;
+    for (ByteAddr chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize) {
+        auto instructionDisassembler = architecture()->instructionDisassembler()->clone();
+        if (!instructionDisassembler) {
+            disassemble(source, begin, end, canceled);
+            return;
+        }
+        chunks.push_back(std::unique_ptr<ChunkDisassembler>(new ChunkDisassembler(
+            architecture(), std::move(instructionDisassembler), chunkBegin, std::min(chunkBegin + chunkSize, end))));
+    }
+
+    parallelForEach(chunks, threadCount, [&](const std::unique_ptr<ChunkDisassembler> &chunk) {
+        chunk->run(source, end, canceled);
+    });
+
+    /* Merge the chunks, resynchronizing the decoding at their starts. */
+    ByteAddr pc = begin;
+    foreach (const auto &chunk, chunks) {
+        std::vector<std::unique_ptr<Instruction>> &result = chunk->result();
+
+        while (pc < chunk->end()) {
+            auto i = std::lower_bound(result.begin(), result.end(), pc, addrLess);
+
+            if (i != result.end() && (*i)->addr() == pc) {
+                for (; i != result.end(); ++i) {
+                    addInstruction(std::move(*i));
+                }
+                pc = chunk->stop();
+
+                /* Decoding was aborted or canceled. */
+                if (pc < chunk->end()) {
+                    return;
+                }
+                break;
+            }
+
+            ByteAddr target = i != result.end() ? (*i)->addr() : chunk->end();
+            ByteAddr next = disassembleRange(source, pc, target, end, canceled);
+            if (next < target) {
+                return;
+            }
+            pc = next;
+        }
+
+        result.clear();
+    }
+}
+
+ByteAddr Disassembler::disassembleRange(const image::ByteSource *source, ByteAddr begin, ByteAddr end, ByteAddr limit, const CancellationToken &canceled) {
+    assert(source != NULL);
+    assert(end <= limit);
+
     SmallByteSize maxInstructionSize = architecture()->maxInstructionSize();
 
+    /* Copy buffer, used only if the source gives no direct access to its bytes. */
     const ByteSize bufferCapacity = std::max(4096, maxInstructionSize);
-    std::unique_ptr<char[]> buffer(new char[bufferCapacity]);
+    std::unique_ptr<char[]> buffer;
 
-    ByteOffset bufferOffset = 0;
-    ByteSize bufferSize = 0;
+    const char *data = NULL;
+    ByteOffset dataOffset = 0;
+    ByteSize dataSize = 0;
 
     while (begin < end && !canceled) {
-        if (bufferOffset + maxInstructionSize > bufferSize && end - begin > bufferSize - bufferOffset) {
-            bufferOffset = 0;
-            bufferSize = source->readBytes(begin, buffer.get(), std::min(end - begin, bufferCapacity));
+        if (dataOffset + maxInstructionSize > dataSize && limit - begin > dataSize - dataOffset) {
+            dataOffset = 0;
+            data = source->getBytes(begin, &dataSize);
+            if (data) {
+                dataSize = std::min(dataSize, limit - begin);
+            }
+            /* Too short a span: the next bytes may be reachable only by copying. */
+            if (!data || (dataSize < maxInstructionSize && dataSize < limit - begin)) {
+                if (!buffer) {
+                    buffer.reset(new char[bufferCapacity]);
+                }
+                data = buffer.get();
+                dataSize = source->readBytes(begin, buffer.get(), std::min(limit - begin, bufferCapacity));
+            }
         }
-        if (bufferOffset >= bufferSize) {
+        if (dataOffset >= dataSize) {
             break;
         }
 
-        auto instruction = disassembleInstruction(begin, buffer.get() + bufferOffset, bufferSize - bufferOffset);
+        auto instruction = disassembleInstruction(begin, data + dataOffset,
+            static_cast<SmallByteSize>(std::min<ByteSize>(dataSize - dataOffset, bufferCapacity)));
 
         ByteSize instructionSize = 1;
         if (instruction) {
             if (!instruction->size()) {
                 ncWarning("Size of instruction at address %1 is undefined. Aborting.", instruction->addr());
-                return;
+                return begin;
             }
             instructionSize = instruction->size();
             addInstruction(std::move(instruction));
         }
 
         begin += instructionSize;
-        bufferOffset += instructionSize;
+        dataOffset += instructionSize;
     }
+
+    return begin;
 }
 
 std::unique_ptr<Instruction> Disassembler::disassembleInstruction(ByteAddr pc, const void *buffer, SmallByteSize size) {
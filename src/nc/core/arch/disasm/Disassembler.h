@@ -93,8 +93,46 @@ class Disassembler {
      */
     virtual void disassemble(const image::ByteSource *source, ByteAddr begin, ByteAddr end, const CancellationToken &canceled);
 
+    /**
+     * Disassembles all instructions in the given range of addresses,
+     * splitting the range into chunks decoded concurrently.
+     *
+     * Each chunk is decoded by its own copy of the architecture's instruction
+     * disassembler, as if it started at an instruction boundary. When merging,
+     * the decoding is resynchronized at the start of every chunk by decoding
+     * from the end of the last instruction of the previous chunk until
+     * an instruction of the chunk is met. The result is the same as
+     * of disassemble(), and instructions are passed to addInstruction()
+     * in the calling thread in the order of their addresses.
+     *
+     * If the range is small, threadCount is less than two, or the instruction
+     * disassembler cannot be copied, the method just calls disassemble().
+     *
+     * \param source Valid pointer to a byte source, safe to read concurrently.
+     * \param begin First address in the range.
+     * \param end First address past the range.
+     * \param threadCount Maximal number of threads to use.
+     * \param canceled Cancellation token.
+     */
+    void disassembleInParallel(const image::ByteSource *source, ByteAddr begin, ByteAddr end, int threadCount, const CancellationToken &canceled);
+
     protected:
 
+    /**
+     * Disassembles instructions starting in the given range of addresses.
+     * Bytes up to the given limit are available for decoding, so that
+     * the last instruction can cross the end of the range.
+     *
+     * \param source Valid pointer to a byte source.
+     * \param begin First address in the range.
+     * \param end First address past the range.
+     * \param limit First address past the readable bytes, no less than end.
+     * \param canceled Cancellation token.
+     *
+     * \return Address where the next instruction would be decoded from.
+     */
+    ByteAddr disassembleRange(const image::ByteSource *source, ByteAddr begin, ByteAddr end, ByteAddr limit, const CancellationToken &canceled);
+
     /**
      * Disassembles a single instruction.
      * By default, the method uses the InstructionDisassembler provided in the architecture.
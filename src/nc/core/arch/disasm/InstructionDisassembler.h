@@ -53,6 +53,14 @@ class InstructionDisassembler {
      * \return Pointer to the instruction disassembled from the buffer, if disassembling succeeded, or NULL otherwise.
      */
     virtual std::unique_ptr<Instruction> disassemble(ByteAddr pc, const void *buffer, ByteSize size) const = 0;
+
+    /**
+     * Creates a disassembler of the same kind having its own decoder state.
+     * Different copies can be used concurrently from different threads.
+     *
+     * \return Pointer to the new disassembler, or NULL if the disassembler cannot be copied.
+     */
+    virtual std::unique_ptr<InstructionDisassembler> clone() const { return NULL; }
 };
 
 } // namespace disasm
@@ -0,0 +1,196 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "RecursiveDisassembler.h"
+
+#include <algorithm> /* std::min() */
+#include <memory>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/Warnings.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Instruction.h>
+#include <nc/core/arch/Instructions.h>
+#include <nc/core/arch/irgen/InstructionAnalyzer.h>
+#include <nc/core/arch/irgen/InvalidInstructionException.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Section.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+#include <nc/core/ir/dflow/Dataflow.h>
+#include <nc/core/ir/dflow/DataflowAnalyzer.h>
+#include <nc/core/ir/dflow/SimulationContext.h>
+#include <nc/core/ir/dflow/Value.h>
+
+namespace nc {
+namespace core {
+namespace arch {
+namespace disasm {
+
+void RecursiveDisassembler::addEntry(ByteAddr addr) {
+    if (visited_.insert(addr).second) {
+        queue_.push_back(addr);
+    }
+}
+
+void RecursiveDisassembler::disassemble(const CancellationToken &canceled) {
+    while (!queue_.empty() && !canceled) {
+        ByteAddr addr = queue_.front();
+        queue_.pop_front();
+
+        disassembleAt(addr);
+    }
+}
+
+void RecursiveDisassembler::disassembleAt(ByteAddr addr) {
+    const image::Section *section = image()->getSectionContainingAddress(addr);
+    if (!section || !section->isCode()) {
+        return;
+    }
+
+    if (instructions()) {
+        if (const auto &instruction = instructions()->get(addr)) {
+            addSuccessors(instruction.get());
+            return;
+        }
+    }
+
+    SmallByteSize maxInstructionSize = architecture()->maxInstructionSize();
+    ByteSize size = std::min<ByteSize>(section->endAddr() - addr, maxInstructionSize);
+
+    std::unique_ptr<char[]> buffer;
+    ByteSize dataSize;
+    const char *data = section->getBytes(addr, &dataSize);
+
+    if (!data || dataSize < size) {
+        buffer.reset(new char[maxInstructionSize]);
+        data = buffer.get();
+        dataSize = section->readBytes(addr, buffer.get(), size);
+    }
+    if (dataSize <= 0) {
+        return;
+    }
+
+    auto instruction = disassembleInstruction(addr, data, static_cast<SmallByteSize>(std::min(dataSize, size)));
+    if (!instruction) {
+        return;
+    }
+    if (!instruction->size()) {
+        ncWarning("Size of instruction at address %1 is undefined.", instruction->addr());
+        return;
+    }
+
+    addSuccessors(instruction.get());
+    addInstruction(std::move(instruction));
+}
+
+void RecursiveDisassembler::addSuccessors(const Instruction *instruction) {
+    assert(instruction != NULL);
+
+    ir::Program program;
+
+    try {
+        architecture()->instructionAnalyzer()->createStatements(instruction, &program);
+    } catch (const irgen::InvalidInstructionException &e) {
+        /* Semantics are unknown: assume that the control just goes further. */
+        ncWarning(e.unicodeWhat());
+        addEntry(instruction->endAddr());
+        return;
+    }
+
+    foreach (const ir::BasicBlock *basicBlock, program.basicBlocks()) {
+        /*
+         * Most jumps and calls have constant targets right in the IR:
+         * take them directly and run the dataflow analysis only for
+         * the basic blocks where a target has to be computed.
+         */
+        bool computedTargets = false;
+
+        auto addTarget = [&](const ir::Term *term) {
+            if (const ir::Constant *constant = term->asConstant()) {
+                addEntry(constant->value().value());
+            } else {
+                computedTargets = true;
+            }
+        };
+
+        foreach (const ir::Statement *statement, basicBlock->statements()) {
+            if (const ir::Call *call = statement->asCall()) {
+                addTarget(call->target());
+            } else if (const ir::Jump *jump = statement->asJump()) {
+                if (jump->thenTarget().address()) {
+                    addTarget(jump->thenTarget().address());
+                }
+                if (jump->elseTarget().address()) {
+                    addTarget(jump->elseTarget().address());
+                }
+            }
+        }
+
+        if (computedTargets) {
+            /* Quick and dirty dataflow analysis, as in IRGenerator::computeJumpTargets(). */
+            ir::dflow::Dataflow dataflow;
+            ir::dflow::DataflowAnalyzer analyzer(dataflow, architecture(), NULL);
+            ir::dflow::SimulationContext context(analyzer);
+
+            auto addComputedTarget = [&](const ir::Term *term) {
+                if (!term->asConstant()) {
+                    const ir::dflow::Value *addressValue = dataflow.getValue(term);
+                    if (addressValue->isConstant()) {
+                        addEntry(addressValue->constantValue().value());
+                    }
+                }
+            };
+
+            foreach (const ir::Statement *statement, basicBlock->statements()) {
+                analyzer.simulate(statement, context);
+
+                if (const ir::Call *call = statement->asCall()) {
+                    addComputedTarget(call->target());
+                } else if (const ir::Jump *jump = statement->asJump()) {
+                    if (jump->thenTarget().address()) {
+                        addComputedTarget(jump->thenTarget().address());
+                    }
+                    if (jump->elseTarget().address()) {
+                        addComputedTarget(jump->elseTarget().address());
+                    }
+                }
+            }
+        }
+
+        /* A memory-bound basic block without a terminator falls through. */
+        if (!basicBlock->getTerminator() && basicBlock->successorAddress()) {
+            addEntry(*basicBlock->successorAddress());
+        }
+    }
+}
+
+} // namespace disasm
+} // namespace arch
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
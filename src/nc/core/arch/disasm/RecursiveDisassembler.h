@@ -0,0 +1,119 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <deque>
+
+#include <boost/unordered_set.hpp>
+
+#include "Disassembler.h"
+
+namespace nc {
+namespace core {
+
+namespace image {
+    class Image;
+}
+
+namespace arch {
+namespace disasm {
+
+/**
+ * Disassembler following the control flow from a set of entry addresses.
+ *
+ * Starting from the addresses added by addEntry(), the disassembler decodes
+ * an instruction, lifts it to the intermediate representation and queues
+ * the constant targets of its jumps and calls, as well as the next
+ * instruction if the control can fall through to it. Only addresses inside
+ * code sections of the image are disassembled. Targets computed from memory
+ * (e.g. jump tables) are not followed; use the linear Disassembler to fill
+ * the remaining gaps.
+ */
+class RecursiveDisassembler: public Disassembler {
+    const image::Image *image_; ///< Image.
+    std::deque<ByteAddr> queue_; ///< Addresses waiting to be disassembled.
+    boost::unordered_set<ByteAddr> visited_; ///< Addresses ever queued.
+
+    public:
+
+    /**
+     * Constructor.
+     *
+     * \param[in] architecture Valid pointer to the architecture.
+     * \param[out] instructions Pointer to the set of instructions where to add disassembled instructions.
+     *                          Can be NULL, but then you must override addInstruction().
+     * \param[in] image Valid pointer to the image being disassembled.
+     */
+    RecursiveDisassembler(Architecture *architecture, Instructions *instructions, const image::Image *image):
+        Disassembler(architecture, instructions),
+        image_(image)
+    {
+        assert(image);
+    }
+
+    /**
+     * \return Valid pointer to the image.
+     */
+    const image::Image *image() const { return image_; }
+
+    /**
+     * Queues an address to start the disassembly from.
+     * Addresses queued before are ignored.
+     *
+     * \param addr Address.
+     */
+    void addEntry(ByteAddr addr);
+
+    using Disassembler::disassemble;
+
+    /**
+     * Disassembles all the instructions reachable from the queued addresses.
+     *
+     * \param canceled Cancellation token.
+     */
+    void disassemble(const CancellationToken &canceled);
+
+    private:
+
+    /**
+     * Disassembles a single instruction at the given address and queues its successors.
+     *
+     * \param addr Address of the instruction.
+     */
+    void disassembleAt(ByteAddr addr);
+
+    /**
+     * Queues the addresses to which the control can be transferred after
+     * the given instruction.
+     *
+     * \param instruction Valid pointer to the instruction.
+     */
+    void addSuccessors(const Instruction *instruction);
+};
+
+} // namespace disasm
+} // namespace arch
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -21,8 +21,9 @@
 
 #include "BufferByteSource.h"
 
+#include <algorithm> /* std::min(), std::max() */
 #include <cassert>
-#include <cstring> /* memcpy */
+#include <cstring> /* memcpy, memset */
 
 namespace nc {
 namespace core {
@@ -31,15 +32,33 @@ namespace image {
 ByteSize BufferByteSource::readBytes(ByteAddr addr, void *buf, ByteSize size) const {
     assert(size >= 0);
 
-    if (addr + size > buffer().size()) {
-        size = buffer().size() - addr;
+    ByteSize totalSize = buffer().size() + zeroSize_;
+
+    if (addr < 0 || addr >= totalSize) {
+        return 0;
     }
+    size = std::min(size, totalSize - addr);
 
-    memcpy(buf, buffer().constData() + addr, size);
+    ByteSize copied = std::max<ByteSize>(std::min<ByteSize>(size, buffer().size() - addr), 0);
+    if (copied > 0) {
+        memcpy(buf, buffer().constData() + addr, copied);
+    }
+    memset(static_cast<char *>(buf) + copied, 0, size - copied);
 
     return size;
 }
 
+const char *BufferByteSource::getBytes(ByteAddr addr, ByteSize *size) const {
+    assert(size != NULL);
+
+    if (addr < 0 || addr >= buffer().size()) {
+        return NULL;
+    }
+
+    *size = buffer().size() - addr;
+    return buffer().constData() + addr;
+}
+
 } // namespace image
 } // namespace core
 } // namespace nc
@@ -22,6 +22,8 @@
 
 #include <nc/config.h>
 
+#include <cassert>
+
 #include <QByteArray>
 
 #include "ByteSource.h"
@@ -31,24 +33,29 @@ namespace core {
 namespace image {
 
 /**
- * ByteSource reading the bytes from a QIODevice.
+ * ByteSource reading the bytes from a QIODevice, optionally followed by zeroes.
  */
 class BufferByteSource: public ByteSource {
     QByteArray buffer_; ///< Buffer to read from.
+    ByteSize zeroSize_; ///< Number of zero bytes following the buffer.
 
     public:
 
     /**
      * Default constructor.
      */
-    BufferByteSource() {}
+    BufferByteSource(): zeroSize_(0) {}
 
     /**
      * Constructor.
      *
      * \param buffer Buffer to read from.
+     * \param zeroSize Number of zero bytes following the buffer.
+     *                 They are not stored, so this can be large.
      */
-    BufferByteSource(const QByteArray &buffer): buffer_(buffer) {}
+    BufferByteSource(const QByteArray &buffer, ByteSize zeroSize = 0): buffer_(buffer), zeroSize_(zeroSize) {
+        assert(zeroSize >= 0);
+    }
 
     /**
      * Buffer to read from.
@@ -61,6 +68,8 @@ class BufferByteSource: public ByteSource {
     const QByteArray &buffer() const { return buffer_; }
 
     virtual ByteSize readBytes(ByteAddr addr, void *buf, ByteSize size) const override;
+
+    virtual const char *getBytes(ByteAddr addr, ByteSize *size) const override;
 };
 
 } // namespace image
@@ -49,6 +49,20 @@ class ByteSource {
      * \return                         Number of bytes actually read and copied into the buffer.
      */
     virtual ByteSize readBytes(ByteAddr addr, void *buf, ByteSize size) const = 0;
+
+    /**
+     * Gives direct access to the bytes of the source, if they are stored
+     * contiguously in memory. The pointer stays valid as long as the source
+     * exists and is not modified.
+     *
+     * \param[in] addr                 Linear address of the first byte.
+     * \param[out] size                Number of bytes available starting from the returned pointer.
+     *
+     * \return                         Pointer to the byte at the given address, or NULL
+     *                                 if the source cannot give direct access to it.
+     *                                 In the latter case, use readBytes().
+     */
+    virtual const char *getBytes(ByteAddr /*addr*/, ByteSize * /*size*/) const { return NULL; }
 };
 
 } // namespace image
@@ -21,6 +21,8 @@
 
 #include "Image.h"
 
+#include <algorithm> /* std::min(), std::max() */
+
 #include <nc/common/Foreach.h>
 #include <nc/common/Warnings.h>
 
@@ -39,16 +41,48 @@ Image::~Image() {
 Section *Image::createSection(const QString &name, ByteAddr addr, ByteSize size) {
     std::unique_ptr<Section> result(new Section(module(), name, addr, size));
     sections_.push_back(result.get());
+
+    /*
+     * Cover the parts of [addr, addr + size) not yet covered by other sections.
+     */
+    ByteAddr endAddr = addr + size;
+
+    auto i = intervals_.upper_bound(addr);
+    if (i != intervals_.begin()) {
+        auto previous = i;
+        --previous;
+        addr = std::max(addr, previous->second.endAddr);
+    }
+
+    while (addr < endAddr) {
+        ByteAddr gapEndAddr = i == intervals_.end() ? endAddr : std::min(endAddr, i->first);
+        if (addr < gapEndAddr) {
+            intervals_.insert(i, std::make_pair(addr, Interval(gapEndAddr, result.get())));
+        }
+        if (i == intervals_.end()) {
+            break;
+        }
+        addr = std::max(addr, i->second.endAddr);
+        ++i;
+    }
+
     return result.release();
 }
 
-const Section *Image::getSectionContainingAddress(ByteAddr addr) const {
-    foreach (Section *section, sections_) {
-        if (section->containsAddress(addr)) {
-            return section;
+std::map<ByteAddr, Image::Interval>::const_iterator Image::findInterval(ByteAddr addr) const {
+    auto i = intervals_.upper_bound(addr);
+    if (i != intervals_.begin()) {
+        --i;
+        if (addr < i->second.endAddr) {
+            return i;
         }
     }
-    return NULL;
+    return intervals_.end();
+}
+
+const Section *Image::getSectionContainingAddress(ByteAddr addr) const {
+    auto i = findInterval(addr);
+    return i != intervals_.end() ? i->second.section : NULL;
 }
 
 const Section *Image::getSectionByName(const QString &name) const {
@@ -63,11 +97,45 @@ const Section *Image::getSectionByName(const QString &name) const {
 ByteSize Image::readBytes(ByteAddr addr, void *buf, ByteSize size) const {
     if (externalByteSource()) {
         return externalByteSource()->readBytes(addr, buf, size);
-    } else if (const Section *section = getSectionContainingAddress(addr)) {
-        return section->readBytes(addr, buf, size);
-    } else {
-        return 0;
     }
+
+    /*
+     * Read interval by interval, so that reads spanning adjacent sections succeed.
+     */
+    ByteSize result = 0;
+    auto i = findInterval(addr);
+
+    while (result < size && i != intervals_.end() && i->first <= addr) {
+        ByteSize chunkSize = std::min(size - result, i->second.endAddr - addr);
+        ByteSize bytesRead = i->second.section->readBytes(addr, static_cast<char *>(buf) + result, chunkSize);
+
+        result += bytesRead;
+        addr += bytesRead;
+
+        if (bytesRead < chunkSize) {
+            break;
+        }
+        ++i;
+    }
+
+    return result;
+}
+
+const char *Image::getBytes(ByteAddr addr, ByteSize *size) const {
+    if (externalByteSource()) {
+        return externalByteSource()->getBytes(addr, size);
+    }
+
+    auto i = findInterval(addr);
+    if (i == intervals_.end()) {
+        return NULL;
+    }
+
+    const char *result = i->second.section->getBytes(addr, size);
+    if (result) {
+        *size = std::min(*size, i->second.endAddr - addr);
+    }
+    return result;
 }
 
 } // namespace image
@@ -22,6 +22,7 @@
 
 #include <nc/config.h>
 
+#include <map>
 #include <vector>
 
 #include "Reader.h"
@@ -43,6 +44,23 @@ namespace image {
  */
 class Image: public Reader {
     std::vector<Section *> sections_; ///< Sections of the executable file.
+
+    /**
+     * Address interval covered by a section.
+     */
+    struct Interval {
+        ByteAddr endAddr; ///< End address of the interval.
+        const Section *section; ///< Section covering the interval.
+
+        Interval(ByteAddr endAddr, const Section *section): endAddr(endAddr), section(section) {}
+    };
+
+    /**
+     * Disjoint address intervals covered by the sections, keyed by their start addresses.
+     * Where sections overlap, the interval belongs to the one created first.
+     */
+    std::map<ByteAddr, Interval> intervals_;
+
     std::unique_ptr<ByteSource> externalByteSource_; ///< External source of this image's bytes.
 
 public:
@@ -60,6 +78,7 @@ public:
 
     /**
      * Creates a new section.
+     * Address and size of a section cannot be changed after its creation.
      *
      * \param name                      Section name.
      * \param addr                      Section's address.
@@ -77,6 +96,8 @@ public:
      *
      * \return                         Section containing given virtual address, 
      *                                 or 0 if there is no such section.
+     *                                 If several sections contain the address,
+     *                                 the one created first is returned.
      */
     const Section *getSectionContainingAddress(ByteAddr addr) const;
     
@@ -101,6 +122,17 @@ public:
     void setExternalByteSource(std::unique_ptr<ByteSource> byteSource) { externalByteSource_ = std::move(byteSource); }
 
     virtual ByteSize readBytes(ByteAddr addr, void *buf, ByteSize size) const override;
+
+    virtual const char *getBytes(ByteAddr addr, ByteSize *size) const override;
+
+    private:
+
+    /**
+     * \param addr Linear address.
+     *
+     * \return Iterator to the interval containing the address, or intervals_.end() if there is none.
+     */
+    std::map<ByteAddr, Interval>::const_iterator findInterval(ByteAddr addr) const;
 };
 
 } // namespace image
@@ -0,0 +1,49 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "MappedFile.h"
+
+namespace nc {
+namespace core {
+namespace image {
+
+MappedFile::MappedFile(const QString &filename):
+    file_(filename), data_(NULL), size_(0)
+{
+    if (file_.open(QIODevice::ReadOnly) && file_.size() > 0) {
+        if (uchar *data = file_.map(0, file_.size())) {
+            data_ = reinterpret_cast<const char *>(data);
+            size_ = file_.size();
+        }
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        file_.unmap(reinterpret_cast<uchar *>(const_cast<char *>(data_)));
+    }
+}
+
+} // namespace image
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
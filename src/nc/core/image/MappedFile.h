@@ -0,0 +1,72 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <QFile>
+
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+namespace image {
+
+/**
+ * Read-only file mapped into memory as a whole.
+ */
+class MappedFile: boost::noncopyable {
+    QFile file_; ///< Mapped file.
+    const char *data_; ///< Contents of the file.
+    ByteSize size_; ///< Size of the file.
+
+    public:
+
+    /**
+     * Constructor. Opens and maps the file.
+     *
+     * \param filename Name of the file.
+     */
+    explicit MappedFile(const QString &filename);
+
+    /**
+     * Destructor. Unmaps and closes the file.
+     */
+    ~MappedFile();
+
+    /**
+     * \return Pointer to the contents of the file, or NULL if the file could not be mapped.
+     */
+    const char *data() const { return data_; }
+
+    /**
+     * \return Size of the file, if it is mapped, or 0 otherwise.
+     */
+    ByteSize size() const { return size_; }
+};
+
+} // namespace image
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
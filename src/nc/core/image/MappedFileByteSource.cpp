@@ -0,0 +1,80 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "MappedFileByteSource.h"
+
+#include <algorithm> /* std::min(), std::max() */
+#include <cassert>
+#include <cstring> /* memcpy, memset */
+
+#include "MappedFile.h"
+
+namespace nc {
+namespace core {
+namespace image {
+
+MappedFileByteSource::MappedFileByteSource(const std::shared_ptr<const MappedFile> &file, ByteOffset offset, ByteSize fileSize, ByteSize size):
+    file_(file), data_(NULL), fileSize_(0), size_(size)
+{
+    assert(file || fileSize == 0);
+    assert(offset >= 0);
+    assert(fileSize >= 0);
+    assert(size >= 0);
+
+    if (file && file->data() && offset < file->size()) {
+        data_ = file->data() + offset;
+        fileSize_ = std::min(std::min(fileSize, file->size() - offset), size);
+    }
+}
+
+ByteSize MappedFileByteSource::readBytes(ByteAddr addr, void *buf, ByteSize size) const {
+    assert(size >= 0);
+
+    if (addr < 0 || addr >= size_) {
+        return 0;
+    }
+    size = std::min(size, size_ - addr);
+
+    ByteSize copied = std::max<ByteSize>(std::min(size, fileSize_ - addr), 0);
+    if (copied > 0) {
+        memcpy(buf, data_ + addr, copied);
+    }
+    memset(static_cast<char *>(buf) + copied, 0, size - copied);
+
+    return size;
+}
+
+const char *MappedFileByteSource::getBytes(ByteAddr addr, ByteSize *size) const {
+    assert(size != NULL);
+
+    if (addr < 0 || addr >= fileSize_) {
+        return NULL;
+    }
+
+    *size = fileSize_ - addr;
+    return data_ + addr;
+}
+
+} // namespace image
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
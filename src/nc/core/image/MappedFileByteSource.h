@@ -0,0 +1,76 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <memory> /* std::shared_ptr */
+
+#include "ByteSource.h"
+
+namespace nc {
+namespace core {
+namespace image {
+
+class MappedFile;
+
+/**
+ * ByteSource giving a view of a range of a memory-mapped file,
+ * optionally followed by zeroes.
+ *
+ * Bytes are neither copied nor allocated: getBytes() points directly
+ * into the mapping, and the zero-filled tail (e.g. of a BSS section)
+ * exists only as zeroes written by readBytes().
+ */
+class MappedFileByteSource: public ByteSource {
+    std::shared_ptr<const MappedFile> file_; ///< Mapped file.
+    const char *data_; ///< First byte of the range in the file.
+    ByteSize fileSize_; ///< Number of bytes taken from the file.
+    ByteSize size_; ///< Total number of bytes, including the zero-filled tail.
+
+    public:
+
+    /**
+     * Constructor.
+     *
+     * \param file Pointer to the mapped file. Can be NULL if fileSize is zero.
+     * \param offset Offset of the range in the file.
+     * \param fileSize Number of bytes in the file range. Bytes past the end
+     *                 of the file are treated as zeroes.
+     * \param size Total number of bytes. The bytes following the file range are zeroes.
+     */
+    MappedFileByteSource(const std::shared_ptr<const MappedFile> &file, ByteOffset offset, ByteSize fileSize, ByteSize size);
+
+    /**
+     * \return Total number of bytes, including the zero-filled tail.
+     */
+    ByteSize size() const { return size_; }
+
+    virtual ByteSize readBytes(ByteAddr addr, void *buf, ByteSize size) const override;
+
+    virtual const char *getBytes(ByteAddr addr, ByteSize *size) const override;
+};
+
+} // namespace image
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -21,7 +21,11 @@
 
 #include "Reader.h"
 
+#include <algorithm> /* std::min() */
 #include <cassert>
+#include <cstring> /* memchr() */
+
+#include <QByteArray>
 
 #include <nc/core/Module.h>
 #include <nc/core/arch/Architecture.h>
@@ -37,16 +41,37 @@ QString Reader::readAsciizString(ByteAddr addr, ByteSize maxSize) const {
         return QString();
     }
 
-    std::unique_ptr<char[]> buf(new char[maxSize + 1]);
+    /* Fast path: the string lies in contiguous memory. */
+    ByteSize spanSize;
+    if (const char *span = getBytes(addr, &spanSize)) {
+        ByteSize size = std::min(spanSize, maxSize);
+        if (const char *end = static_cast<const char *>(memchr(span, '\0', size))) {
+            return QString::fromLatin1(span, static_cast<int>(end - span));
+        } else if (size == maxSize) {
+            return QString::fromLatin1(span, static_cast<int>(size));
+        }
+    }
+
+    /* Slow path: read the string in chunks until the terminator. */
+    QByteArray result;
+    char buf[256];
 
-    ByteSize size = readBytes(addr, buf.get(), maxSize);
-    assert(size <= maxSize);
+    while (result.size() < maxSize) {
+        ByteSize size = readBytes(addr + result.size(), buf, std::min(static_cast<ByteSize>(sizeof(buf)), maxSize - result.size()));
+        if (size == 0) {
+            break;
+        }
+        if (const char *end = static_cast<const char *>(memchr(buf, '\0', size))) {
+            result.append(buf, static_cast<int>(end - buf));
+            return QString::fromLatin1(result.constData(), result.size());
+        }
+        result.append(buf, static_cast<int>(size));
+    }
 
-    if (size == 0) {
+    if (result.isEmpty()) {
         return QString();
     } else {
-        buf.get()[size] = '\0';
-        return QString::fromLatin1(buf.get());
+        return QString::fromLatin1(result.constData(), result.size());
     }
 }
 
@@ -45,6 +45,16 @@ ByteSize Section::readBytes(ByteAddr addr, void *buf, ByteSize size) const {
     }
 }
 
+const char *Section::getBytes(ByteAddr addr, ByteSize *size) const {
+    if (externalByteSource()) {
+        return externalByteSource()->getBytes(addr - addr_, size);
+    } else if (module()->image()->externalByteSource()) {
+        return module()->image()->externalByteSource()->getBytes(addr, size);
+    } else {
+        return NULL;
+    }
+}
+
 } // namespace image
 } // namespace core
 } // namespace nc
@@ -94,23 +94,11 @@ public:
      */
     ByteAddr endAddr() const { return addr_ + size_; }
 
-    /**
-     * \param[in] addr                 New address of section start.
-     */
-    void setAddr(ByteAddr addr) { addr_ = addr; }
-
     /**
      * \return                         Size of the section.
      */
     ByteSize size() const { return size_; }
 
-    /**
-     * Sets size of the section.
-     *
-     * \param[in] size                 New size of the section.
-     */
-    void setSize(ByteSize size) { size_ = size; }
-
     /**
      * \return                         True if the section occupied memory.
      */
@@ -213,6 +201,8 @@ public:
     void setExternalByteSource(std::unique_ptr<ByteSource> byteSource) { externalByteSource_ = std::move(byteSource); }
 
     virtual ByteSize readBytes(ByteAddr addr, void *buf, ByteSize size) const override;
+
+    virtual const char *getBytes(ByteAddr addr, ByteSize *size) const override;
 };
 
 } // namespace image
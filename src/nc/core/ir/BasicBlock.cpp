@@ -29,6 +29,7 @@
 
 #include <nc/common/Escaping.h>
 #include <nc/common/Foreach.h>
+#include <nc/common/ObjectPool.h>
 
 #include <boost/range/algorithm/find.hpp>
 
@@ -42,6 +43,21 @@ BasicBlock::BasicBlock(const boost::optional<ByteAddr> &address):
 
 BasicBlock::~BasicBlock() {}
 
+namespace {
+
+/** Pool the basic blocks are allocated from. */
+ObjectPool *const basicBlockPool = new ObjectPool();
+
+} // anonymous namespace
+
+void *BasicBlock::operator new(std::size_t size) {
+    return basicBlockPool->allocate(size);
+}
+
+void BasicBlock::operator delete(void *pointer, std::size_t size) {
+    basicBlockPool->deallocate(pointer, size);
+}
+
 void BasicBlock::setSuccessorAddress(const boost::optional<ByteAddr> &successorAddress) {
     assert((!successorAddress || address()) && "A non-memory-bound basic block cannot have a successor address.");
     successorAddress_ = successorAddress;
@@ -61,6 +61,23 @@ class BasicBlock: public PrintableBase<BasicBlock>, boost::noncopyable {
      */
     ~BasicBlock();
 
+    /**
+     * Allocates memory for a basic block from the pool shared by all basic blocks.
+     *
+     * \param size Size of the object.
+     *
+     * \return Valid pointer to the memory.
+     */
+    static void *operator new(std::size_t size);
+
+    /**
+     * Returns the memory of a basic block to the pool.
+     *
+     * \param pointer Pointer to the memory. Can be NULL.
+     * \param size Size of the object.
+     */
+    static void operator delete(void *pointer, std::size_t size);
+
     /**
      * \return Address of the basic block.
      */
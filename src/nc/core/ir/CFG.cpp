@@ -23,9 +23,7 @@
 
 #include <QTextStream>
 
-#ifndef NDEBUG
-#include <boost/unordered_set.hpp>
-#endif
+#include <algorithm>
 
 #include <nc/common/Foreach.h>
 
@@ -37,54 +35,135 @@ namespace nc {
 namespace core {
 namespace ir {
 
+namespace {
+
+/**
+ * Appends the basic blocks a jump target can transfer control to.
+ *
+ * \param[in] jumpTarget Jump target.
+ * \param[out] result Vector to append the basic blocks to.
+ */
+void getTargetBasicBlocks(const JumpTarget &jumpTarget, std::vector<const BasicBlock *> &result) {
+    if (jumpTarget.basicBlock()) {
+        result.push_back(jumpTarget.basicBlock());
+    }
+    if (jumpTarget.table()) {
+        foreach (const JumpTableEntry &entry, *jumpTarget.table()) {
+            if (entry.basicBlock()) {
+                result.push_back(entry.basicBlock());
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
 CFG::CFG(const std::vector<const BasicBlock *> &basicBlocks):
     basicBlocks_(basicBlocks)
 {
-    foreach (const BasicBlock *basicBlock, basicBlocks) {
-        if (const Jump *jump = basicBlock->getJump()) {
-            addConnections(basicBlock, jump->thenTarget());
-            addConnections(basicBlock, jump->elseTarget());
-        }
+    const std::size_t size = basicBlocks_.size();
+
+    indices_.rehash(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        indices_[basicBlocks_[i]] = i;
     }
 
-#ifndef NDEBUG
-    boost::unordered_set<const BasicBlock *> set(basicBlocks.begin(), basicBlocks.end());
-    foreach (auto &pair, predecessors_) {
-        assert(nc::contains(set, pair.first));
-        foreach (const BasicBlock *predecessor, pair.second) {
-            assert(nc::contains(set, predecessor));
+    /*
+     * Collect the successors in the order of basic blocks.
+     */
+    successorOffsets_.reserve(size + 1);
+    successorOffsets_.push_back(0);
+
+    std::vector<const BasicBlock *> targets;
+    for (std::size_t i = 0; i < size; ++i) {
+        targets.clear();
+        if (const Jump *jump = basicBlocks_[i]->getJump()) {
+            getTargetBasicBlocks(jump->thenTarget(), targets);
+            getTargetBasicBlocks(jump->elseTarget(), targets);
         }
+
+        foreach (const BasicBlock *target, targets) {
+            auto j = indices_.find(target);
+            assert(j != indices_.end() && "Jump targets must belong to the graph.");
+            if (j != indices_.end()) {
+                successorIndices_.push_back(j->second);
+            }
+        }
+        successorOffsets_.push_back(successorIndices_.size());
+    }
+
+    /*
+     * Compute predecessors by counting sort of the edges by their heads.
+     * The sort is stable, so the predecessors go in the order of basic blocks.
+     */
+    predecessorOffsets_.assign(size + 1, 0);
+    foreach (std::size_t successor, successorIndices_) {
+        ++predecessorOffsets_[successor + 1];
     }
-    foreach (auto &pair, successors_) {
-        assert(nc::contains(set, pair.first));
-        foreach (const BasicBlock *successor, pair.second) {
-            assert(nc::contains(set, successor));
+    for (std::size_t i = 0; i < size; ++i) {
+        predecessorOffsets_[i + 1] += predecessorOffsets_[i];
+    }
+
+    predecessorIndices_.resize(successorIndices_.size());
+    std::vector<std::size_t> positions(predecessorOffsets_.begin(), predecessorOffsets_.end() - 1);
+    for (std::size_t i = 0; i < size; ++i) {
+        foreach (std::size_t successor, getSuccessorIndices(i)) {
+            predecessorIndices_[positions[successor]++] = i;
         }
     }
-#endif
+
+    /*
+     * Materialize the lists of basic blocks.
+     */
+    successors_.reserve(successorIndices_.size());
+    foreach (std::size_t index, successorIndices_) {
+        successors_.push_back(basicBlocks_[index]);
+    }
+    predecessors_.reserve(predecessorIndices_.size());
+    foreach (std::size_t index, predecessorIndices_) {
+        predecessors_.push_back(basicBlocks_[index]);
+    }
 }
 
-void CFG::addConnections(const BasicBlock *predecessor, const JumpTarget &jumpTarget) {
-    assert(predecessor);
+std::vector<const BasicBlock *> CFG::getReversePostorder(const BasicBlock *entry) const {
+    std::vector<const BasicBlock *> result;
+    result.reserve(size());
 
-    if (jumpTarget.basicBlock()) {
-        addConnection(predecessor, jumpTarget.basicBlock());
-    }
-    if (jumpTarget.table()) {
-        foreach (const JumpTableEntry &entry, *jumpTarget.table()) {
-            if (entry.basicBlock()) {
-                addConnection(predecessor, entry.basicBlock());
+    std::vector<bool> visited(size());
+
+    if (entry) {
+        /* Explicit DFS stack: index of a basic block and the position of its next successor to visit. */
+        std::vector<std::pair<std::size_t, std::size_t>> stack;
+
+        std::size_t entryIndex = getIndex(entry);
+        visited[entryIndex] = true;
+        stack.push_back(std::make_pair(entryIndex, successorOffsets_[entryIndex]));
+
+        while (!stack.empty()) {
+            std::size_t index = stack.back().first;
+
+            if (stack.back().second < successorOffsets_[index + 1]) {
+                std::size_t successor = successorIndices_[stack.back().second++];
+                if (!visited[successor]) {
+                    visited[successor] = true;
+                    stack.push_back(std::make_pair(successor, successorOffsets_[successor]));
+                }
+            } else {
+                result.push_back(basicBlocks_[index]);
+                stack.pop_back();
             }
         }
+
+        std::reverse(result.begin(), result.end());
     }
-}
 
-void CFG::addConnection(const BasicBlock *predecessor, const BasicBlock *successor) {
-    assert(predecessor != NULL);
-    assert(successor != NULL);
+    for (std::size_t i = 0; i < size(); ++i) {
+        if (!visited[i]) {
+            result.push_back(basicBlocks_[i]);
+        }
+    }
 
-    successors_[predecessor].push_back(successor);
-    predecessors_[successor].push_back(predecessor);
+    return result;
 }
 
 void CFG::print(QTextStream &out) const {
@@ -92,9 +171,9 @@ void CFG::print(QTextStream &out) const {
         out << *basicBlock;
     }
 
-    foreach (auto &pair, successors_) {
-        foreach (const BasicBlock *successor, pair.second) {
-            out << "basicBlock" << pair.first << " -> basicBlock" << successor << ';' << endl;
+    foreach (const BasicBlock *basicBlock, basicBlocks()) {
+        foreach (const BasicBlock *successor, getSuccessors(basicBlock)) {
+            out << "basicBlock" << basicBlock << " -> basicBlock" << successor << ';' << endl;
         }
     }
 }
@@ -25,6 +25,7 @@
 #include <cassert>
 #include <vector>
 
+#include <boost/range/iterator_range.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <nc/common/Printable.h>
@@ -35,7 +36,6 @@ namespace core {
 namespace ir {
 
 class BasicBlock;
-class JumpTarget;
 
 /**
  * Control flow graph.
@@ -43,16 +43,48 @@ class JumpTarget;
  * Objects of this class can be constructed from a set of basic blocks
  * and contain information about the successors and predecessors of the
  * basic blocks.
+ *
+ * Basic blocks are numbered densely in the order in which they were passed
+ * to the constructor, and the adjacency lists are stored in compressed
+ * sparse row format: the successors (predecessors) of all basic blocks
+ * are kept in one array, the ones of the basic block with index i
+ * occupying the range [offsets[i], offsets[i + 1]). Analyses can use
+ * the indices for addressing vectors and bit sets instead of hash maps.
  */
 class CFG: public PrintableBase<CFG> {
-    /** References to the set of basic blocks passed to the constructor. */
-    const std::vector<const BasicBlock *> &basicBlocks_;
+    public:
+
+    /** Range of basic blocks. */
+    typedef boost::iterator_range<std::vector<const BasicBlock *>::const_iterator> BasicBlockRange;
+
+    /** Range of basic block indices. */
+    typedef boost::iterator_range<std::vector<std::size_t>::const_iterator> IndexRange;
+
+    private:
+
+    /** Basic blocks passed to the constructor. */
+    std::vector<const BasicBlock *> basicBlocks_;
 
-    /** Mapping from a basic block to the list of its successors. */
-    boost::unordered_map<const BasicBlock *, std::vector<const BasicBlock *>> successors_;
+    /** Mapping from a basic block to its index. */
+    boost::unordered_map<const BasicBlock *, std::size_t> indices_;
 
-    /** Mapping from a basic block to the list of its predecessors. */
-    boost::unordered_map<const BasicBlock *, std::vector<const BasicBlock *>> predecessors_;
+    /** Offsets of the basic blocks' successor lists. */
+    std::vector<std::size_t> successorOffsets_;
+
+    /** Indices of the successors of all basic blocks. */
+    std::vector<std::size_t> successorIndices_;
+
+    /** Successors of all basic blocks. */
+    std::vector<const BasicBlock *> successors_;
+
+    /** Offsets of the basic blocks' predecessor lists. */
+    std::vector<std::size_t> predecessorOffsets_;
+
+    /** Indices of the predecessors of all basic blocks. */
+    std::vector<std::size_t> predecessorIndices_;
+
+    /** Predecessors of all basic blocks. */
+    std::vector<const BasicBlock *> predecessors_;
 
     public:
 
@@ -60,9 +92,6 @@ class CFG: public PrintableBase<CFG> {
      * Constructor from a set of basic blocks.
      *
      * \param[in] basicBlocks Basic blocks.
-     *
-     * Note that the set of basic blocks is not copied.
-     * Instead, only a reference to it is stored.
      */
     CFG(const std::vector<const BasicBlock *> &basicBlocks);
 
@@ -71,26 +100,95 @@ class CFG: public PrintableBase<CFG> {
      */
     const std::vector<const BasicBlock *> &basicBlocks() const { return basicBlocks_; }
 
+    /**
+     * \return Number of basic blocks.
+     */
+    std::size_t size() const { return basicBlocks_.size(); }
+
     /**
      * \param[in] basicBlock Valid pointer to a basic block.
      *
-     * \return List of successors of the basic block.
+     * \return True iff the basic block belongs to the graph.
      */
-    const std::vector<const BasicBlock *> getSuccessors(const BasicBlock *basicBlock) const {
+    bool contains(const BasicBlock *basicBlock) const {
         assert(basicBlock != NULL);
-        return nc::find(successors_, basicBlock);
+        return nc::contains(indices_, basicBlock);
+    }
+
+    /**
+     * \param[in] basicBlock Valid pointer to a basic block of the graph.
+     *
+     * \return Index of the basic block.
+     */
+    std::size_t getIndex(const BasicBlock *basicBlock) const {
+        assert(contains(basicBlock));
+        return indices_.find(basicBlock)->second;
+    }
+
+    /**
+     * \param[in] index Index of a basic block.
+     *
+     * \return Valid pointer to the basic block with this index.
+     */
+    const BasicBlock *getBasicBlock(std::size_t index) const {
+        assert(index < size());
+        return basicBlocks_[index];
+    }
+
+    /**
+     * \param[in] basicBlock Valid pointer to a basic block.
+     *
+     * \return List of successors of the basic block.
+     *         Empty if the basic block does not belong to the graph.
+     */
+    BasicBlockRange getSuccessors(const BasicBlock *basicBlock) const {
+        return getRange(successors_, successorOffsets_, basicBlock);
     }
 
     /**
      * \param[in] basicBlock Valid pointer to a basic block.
      *
      * \return List of predecessors of the basic block.
+     *         Empty if the basic block does not belong to the graph.
      */
-    const std::vector<const BasicBlock *> getPredecessors(const BasicBlock *basicBlock) const {
-        assert(basicBlock != NULL);
-        return nc::find(predecessors_, basicBlock);
+    BasicBlockRange getPredecessors(const BasicBlock *basicBlock) const {
+        return getRange(predecessors_, predecessorOffsets_, basicBlock);
+    }
+
+    /**
+     * \param[in] index Index of a basic block.
+     *
+     * \return Indices of the successors of the basic block.
+     */
+    IndexRange getSuccessorIndices(std::size_t index) const {
+        assert(index < size());
+        return IndexRange(successorIndices_.begin() + successorOffsets_[index],
+                          successorIndices_.begin() + successorOffsets_[index + 1]);
+    }
+
+    /**
+     * \param[in] index Index of a basic block.
+     *
+     * \return Indices of the predecessors of the basic block.
+     */
+    IndexRange getPredecessorIndices(std::size_t index) const {
+        assert(index < size());
+        return IndexRange(predecessorIndices_.begin() + predecessorOffsets_[index],
+                          predecessorIndices_.begin() + predecessorOffsets_[index + 1]);
     }
 
+    /**
+     * Computes the reverse postorder of the basic blocks reachable from the entry
+     * in the depth-first traversal of the graph. Unreachable basic blocks
+     * follow the reachable ones in the order in which they were passed
+     * to the constructor.
+     *
+     * \param[in] entry Pointer to the entry basic block. Can be NULL.
+     *
+     * \return All the basic blocks in reverse postorder.
+     */
+    std::vector<const BasicBlock *> getReversePostorder(const BasicBlock *entry) const;
+
     /**
      * Prints the CFG in DOT format into a stream.
      *
@@ -101,20 +199,23 @@ class CFG: public PrintableBase<CFG> {
     private:
 
     /**
-     * Adds an edge from a predecessor to a successor.
+     * \param[in] adjacent Adjacency lists of all basic blocks.
+     * \param[in] offsets Offsets of the adjacency lists.
+     * \param[in] basicBlock Valid pointer to a basic block.
      *
-     * \param[in] predecessor Valid pointer to a predecessor basic block.
-     * \param[in] successor   Valid pointer to a successor basic block.
+     * \return The adjacency list of the given basic block.
      */
-    void addConnection(const BasicBlock *predecessor, const BasicBlock *successor);
+    BasicBlockRange getRange(const std::vector<const BasicBlock *> &adjacent, const std::vector<std::size_t> &offsets,
+                             const BasicBlock *basicBlock) const
+    {
+        assert(basicBlock != NULL);
 
-    /**
-     * Adds edges from a predecessor to all jump targets.
-     *
-     * \param[in] predecessor   Valid pointer to a basic block.
-     * \param[in] jumpTarget    Jump target of the predecessor's terminating jump.
-     */
-    void addConnections(const BasicBlock *predecessor, const JumpTarget &jumpTarget);
+        auto i = indices_.find(basicBlock);
+        if (i == indices_.end()) {
+            return BasicBlockRange(adjacent.end(), adjacent.end());
+        }
+        return BasicBlockRange(adjacent.begin() + offsets[i->second], adjacent.begin() + offsets[i->second + 1]);
+    }
 };
 
 } // namespace ir
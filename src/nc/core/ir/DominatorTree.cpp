@@ -0,0 +1,336 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "DominatorTree.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/unordered_set.hpp>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+
+#include "BasicBlock.h"
+#include "CFG.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+
+DominatorTree::DominatorTree(const CFG &cfg, const BasicBlock *entry, Kind kind):
+    kind_(kind)
+{
+    if (kind == DOMINATORS && !entry) {
+        return;
+    }
+
+    /*
+     * Nodes of the graph are identified by the indices of basic blocks in the CFG.
+     * The virtual exit of the post-dominator tree gets the index following them.
+     */
+    const std::size_t exit = cfg.size();
+
+    /* Basic blocks without successors are the predecessors of the virtual exit. */
+    std::vector<std::size_t> exits;
+    if (kind == POSTDOMINATORS) {
+        for (std::size_t i = 0; i < cfg.size(); ++i) {
+            if (cfg.getSuccessorIndices(i).empty()) {
+                exits.push_back(i);
+            }
+        }
+    }
+
+    auto getSuccessors = [&](std::size_t node) -> CFG::IndexRange {
+        if (kind == DOMINATORS) {
+            return cfg.getSuccessorIndices(node);
+        } else if (node != exit) {
+            return cfg.getPredecessorIndices(node);
+        } else {
+            return CFG::IndexRange(exits.begin(), exits.end());
+        }
+    };
+
+    /*
+     * Number the nodes in reverse postorder.
+     */
+    const std::size_t undefined = static_cast<std::size_t>(-1);
+
+    /* Mapping from the index of a node to its number in reverse postorder. */
+    std::vector<std::size_t> numbers(cfg.size() + 1, undefined);
+
+    /* Nodes in reverse postorder. */
+    std::vector<std::size_t> order;
+    {
+        const std::size_t root = kind == DOMINATORS ? cfg.getIndex(entry) : exit;
+
+        /* Explicit DFS stack: a node and the position of its next successor to visit. */
+        std::vector<std::pair<std::size_t, std::size_t> > stack;
+
+        numbers[root] = 0;
+        stack.push_back(std::make_pair(root, 0));
+
+        while (!stack.empty()) {
+            std::size_t node = stack.back().first;
+            CFG::IndexRange successors = getSuccessors(node);
+
+            if (stack.back().second < static_cast<std::size_t>(successors.size())) {
+                std::size_t successor = successors[stack.back().second++];
+                if (numbers[successor] == undefined) {
+                    numbers[successor] = 0;
+                    stack.push_back(std::make_pair(successor, 0));
+                }
+            } else {
+                order.push_back(node);
+                stack.pop_back();
+            }
+        }
+
+        std::reverse(order.begin(), order.end());
+
+        nodes_.reserve(order.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            numbers[order[i]] = i;
+            nodes_.push_back(order[i] != exit ? cfg.getBasicBlock(order[i]) : NULL);
+            indices_[nodes_.back()] = i;
+        }
+    }
+
+    const std::size_t size = nodes_.size();
+
+    /*
+     * Compute the predecessors of the nodes in terms of their numbers.
+     * The entry of a function can have predecessors too, if it is a loop header.
+     */
+    std::vector<std::vector<std::size_t> > predecessors(size);
+    for (std::size_t i = kind == DOMINATORS ? 0 : 1; i < size; ++i) {
+        std::size_t node = order[i];
+
+        foreach (std::size_t predecessor, kind == DOMINATORS ? cfg.getPredecessorIndices(node) : cfg.getSuccessorIndices(node)) {
+            if (numbers[predecessor] != undefined) {
+                predecessors[i].push_back(numbers[predecessor]);
+            }
+        }
+        if (kind == POSTDOMINATORS && cfg.getSuccessorIndices(node).empty()) {
+            predecessors[i].push_back(0);
+        }
+    }
+
+    /*
+     * Compute immediate dominators.
+     */
+    idoms_.assign(size, undefined);
+    idoms_[0] = 0;
+
+    auto intersect = [&](std::size_t a, std::size_t b) -> std::size_t {
+        while (a != b) {
+            while (a > b) {
+                a = idoms_[a];
+            }
+            while (b > a) {
+                b = idoms_[b];
+            }
+        }
+        return a;
+    };
+
+    bool changed;
+    do {
+        changed = false;
+
+        for (std::size_t i = 1; i < size; ++i) {
+            std::size_t idom = undefined;
+            foreach (std::size_t predecessor, predecessors[i]) {
+                if (idoms_[predecessor] != undefined) {
+                    idom = idom == undefined ? predecessor : intersect(predecessor, idom);
+                }
+            }
+
+            /* The parent in the DFS tree goes earlier in reverse postorder. */
+            assert(idom != undefined);
+
+            if (idoms_[i] != idom) {
+                idoms_[i] = idom;
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    /*
+     * Compute dominance frontiers: walk up from the predecessors of each
+     * join node until reaching its immediate dominator. The root has an
+     * implicit incoming edge, so it is a join node if it has any predecessor,
+     * and the walks to it include the root itself.
+     */
+    frontiers_.resize(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (predecessors[i].size() < (i == 0 ? 1 : 2)) {
+            continue;
+        }
+        foreach (std::size_t predecessor, predecessors[i]) {
+            std::size_t runner = predecessor;
+            while (true) {
+                std::vector<const BasicBlock *> &frontier = frontiers_[runner];
+                if (i != 0 && runner == idoms_[i]) {
+                    break;
+                }
+                if (frontier.empty() || frontier.back() != nodes_[i]) {
+                    frontier.push_back(nodes_[i]);
+                }
+                if (runner == 0) {
+                    break;
+                }
+                runner = idoms_[runner];
+            }
+        }
+    }
+
+    /*
+     * Build the tree and number its nodes.
+     */
+    std::vector<std::vector<std::size_t> > children(size);
+    children_.resize(size);
+    for (std::size_t i = 1; i < size; ++i) {
+        children[idoms_[i]].push_back(i);
+        children_[idoms_[i]].push_back(nodes_[i]);
+    }
+
+    preorder_.resize(size);
+    postorder_.resize(size);
+
+    std::size_t preorderNumber = 0;
+    std::size_t postorderNumber = 0;
+
+    std::vector<std::pair<std::size_t, std::size_t> > stack;
+    preorder_[0] = preorderNumber++;
+    stack.push_back(std::make_pair(0, 0));
+
+    while (!stack.empty()) {
+        std::size_t node = stack.back().first;
+
+        if (stack.back().second < children[node].size()) {
+            std::size_t child = children[node][stack.back().second++];
+            preorder_[child] = preorderNumber++;
+            stack.push_back(std::make_pair(child, 0));
+        } else {
+            postorder_[node] = postorderNumber++;
+            stack.pop_back();
+        }
+    }
+}
+
+std::vector<const BasicBlock *> DominatorTree::basicBlocks() const {
+    std::vector<const BasicBlock *> result;
+    result.reserve(nodes_.size());
+
+    foreach (const BasicBlock *node, nodes_) {
+        if (node) {
+            result.push_back(node);
+        }
+    }
+
+    return result;
+}
+
+bool DominatorTree::contains(const BasicBlock *basicBlock) const {
+    assert(basicBlock != NULL);
+
+    return nc::contains(indices_, basicBlock);
+}
+
+const BasicBlock *DominatorTree::getImmediateDominator(const BasicBlock *basicBlock) const {
+    assert(basicBlock != NULL);
+
+    auto i = indices_.find(basicBlock);
+    if (i == indices_.end() || i->second == 0) {
+        return NULL;
+    }
+    return nodes_[idoms_[i->second]];
+}
+
+const std::vector<const BasicBlock *> &DominatorTree::getChildren(const BasicBlock *basicBlock) const {
+    auto i = indices_.find(basicBlock);
+    if (i != indices_.end()) {
+        return children_[i->second];
+    } else {
+        static const std::vector<const BasicBlock *> empty;
+        return empty;
+    }
+}
+
+bool DominatorTree::dominates(const BasicBlock *a, const BasicBlock *b) const {
+    assert(a != NULL);
+    assert(b != NULL);
+
+    if (a == b) {
+        return true;
+    }
+
+    auto i = indices_.find(a);
+    auto j = indices_.find(b);
+    if (i == indices_.end() || j == indices_.end()) {
+        return false;
+    }
+
+    return preorder_[i->second] <= preorder_[j->second] && postorder_[j->second] <= postorder_[i->second];
+}
+
+const std::vector<const BasicBlock *> &DominatorTree::getDominanceFrontier(const BasicBlock *basicBlock) const {
+    assert(basicBlock != NULL);
+
+    auto i = indices_.find(basicBlock);
+    if (i != indices_.end()) {
+        return frontiers_[i->second];
+    } else {
+        static const std::vector<const BasicBlock *> empty;
+        return empty;
+    }
+}
+
+std::vector<const BasicBlock *> DominatorTree::getIteratedDominanceFrontier(const std::vector<const BasicBlock *> &basicBlocks) const {
+    std::vector<const BasicBlock *> result;
+
+    boost::unordered_set<const BasicBlock *> inResult;
+    boost::unordered_set<const BasicBlock *> visited(basicBlocks.begin(), basicBlocks.end());
+    std::vector<const BasicBlock *> queue(basicBlocks.begin(), basicBlocks.end());
+
+    while (!queue.empty()) {
+        const BasicBlock *basicBlock = queue.back();
+        queue.pop_back();
+
+        foreach (const BasicBlock *frontierBlock, getDominanceFrontier(basicBlock)) {
+            if (inResult.insert(frontierBlock).second) {
+                result.push_back(frontierBlock);
+            }
+            if (visited.insert(frontierBlock).second) {
+                queue.push_back(frontierBlock);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,180 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class BasicBlock;
+class CFG;
+
+/**
+ * Dominator or post-dominator tree of a control flow graph.
+ *
+ * The tree is computed using the iterative algorithm by Cooper, Harvey, and
+ * Kennedy ("A Simple, Fast Dominance Algorithm") on the nodes numbered in
+ * reverse postorder. Dominance queries are answered in constant time using
+ * the preorder and postorder numbers of the nodes in the tree.
+ *
+ * The post-dominator tree is rooted at a virtual exit node, whose
+ * predecessors are the basic blocks without successors. A basic block
+ * immediately post-dominated by this node has no immediate post-dominator.
+ *
+ * Dominance frontiers are computed along with the tree. The frontiers
+ * of a post-dominator tree are the reverse dominance frontiers, i.e.
+ * give the basic blocks on which a basic block is control dependent.
+ */
+class DominatorTree {
+    public:
+
+    /**
+     * Kind of a tree.
+     */
+    enum Kind {
+        DOMINATORS,     ///< Dominator tree.
+        POSTDOMINATORS  ///< Post-dominator tree.
+    };
+
+    private:
+
+    /** Kind of the tree. */
+    Kind kind_;
+
+    /** Nodes in reverse postorder. The root of a post-dominator tree is NULL. */
+    std::vector<const BasicBlock *> nodes_;
+
+    /** Mapping from a basic block to its index in nodes_. */
+    boost::unordered_map<const BasicBlock *, std::size_t> indices_;
+
+    /** Index of the immediate dominator of each node. The root is its own immediate dominator. */
+    std::vector<std::size_t> idoms_;
+
+    /** Children of each node in the tree. */
+    std::vector<std::vector<const BasicBlock *> > children_;
+
+    /** Number of each node in the preorder traversal of the tree. */
+    std::vector<std::size_t> preorder_;
+
+    /** Number of each node in the postorder traversal of the tree. */
+    std::vector<std::size_t> postorder_;
+
+    /** Dominance frontier of each node. */
+    std::vector<std::vector<const BasicBlock *> > frontiers_;
+
+    public:
+
+    /**
+     * Constructor.
+     *
+     * \param cfg   Control flow graph.
+     * \param entry Pointer to the entry basic block. Can be NULL.
+     *              Ignored when building a post-dominator tree.
+     * \param kind  Kind of the tree to build.
+     */
+    DominatorTree(const CFG &cfg, const BasicBlock *entry, Kind kind = DOMINATORS);
+
+    /**
+     * \return Kind of the tree.
+     */
+    Kind kind() const { return kind_; }
+
+    /**
+     * \return Basic blocks present in the tree, in reverse postorder of the
+     *         (reversed, for post-dominators) control flow graph.
+     *         The virtual exit node of a post-dominator tree is not included.
+     */
+    std::vector<const BasicBlock *> basicBlocks() const;
+
+    /**
+     * \param basicBlock Valid pointer to a basic block.
+     *
+     * \return True if the basic block is present in the tree, i.e. is reachable
+     *         from the entry (or reaches an exit, for post-dominators).
+     */
+    bool contains(const BasicBlock *basicBlock) const;
+
+    /**
+     * \param basicBlock Valid pointer to a basic block.
+     *
+     * \return Pointer to the immediate (post-)dominator of the basic block.
+     *         NULL if the basic block is the entry, has no immediate
+     *         post-dominator, or is not present in the tree.
+     */
+    const BasicBlock *getImmediateDominator(const BasicBlock *basicBlock) const;
+
+    /**
+     * \param basicBlock Pointer to a basic block. NULL means the root
+     *                   of a post-dominator tree.
+     *
+     * \return Basic blocks immediately (post-)dominated by the given one.
+     */
+    const std::vector<const BasicBlock *> &getChildren(const BasicBlock *basicBlock) const;
+
+    /**
+     * \param a Valid pointer to a basic block.
+     * \param b Valid pointer to a basic block.
+     *
+     * \return True if a (post-)dominates b. Every basic block dominates itself.
+     */
+    bool dominates(const BasicBlock *a, const BasicBlock *b) const;
+
+    /**
+     * \param a Valid pointer to a basic block.
+     * \param b Valid pointer to a basic block.
+     *
+     * \return True if a strictly (post-)dominates b.
+     */
+    bool strictlyDominates(const BasicBlock *a, const BasicBlock *b) const {
+        return a != b && dominates(a, b);
+    }
+
+    /**
+     * \param basicBlock Valid pointer to a basic block.
+     *
+     * \return Dominance frontier of the basic block: the basic blocks that
+     *         have a predecessor (successor, for post-dominators) dominated
+     *         by the given one, but are not strictly dominated by it.
+     */
+    const std::vector<const BasicBlock *> &getDominanceFrontier(const BasicBlock *basicBlock) const;
+
+    /**
+     * \param basicBlocks Valid pointers to basic blocks.
+     *
+     * \return Iterated dominance frontier of the set of basic blocks,
+     *         i.e. the limit of DF(S), DF(S + DF(S)), ...
+     *         These are the basic blocks needing phi functions for a variable
+     *         assigned in the given basic blocks.
+     */
+    std::vector<const BasicBlock *> getIteratedDominanceFrontier(const std::vector<const BasicBlock *> &basicBlocks) const;
+};
+
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -23,10 +23,14 @@
 
 #include <QTextStream>
 
+#include <boost/unordered_set.hpp>
+
 #include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
 
 #include "BasicBlock.h"
 #include "CFG.h"
+#include "Jump.h"
 #include "Statements.h"
 #include "Term.h"
 
@@ -39,7 +43,68 @@ Function::Function(): entry_(NULL) {}
 Function::~Function() {}
 
 void Function::addBasicBlock(std::unique_ptr<BasicBlock> basicBlock) {
-    basicBlocks_.push_back(std::move(basicBlock));
+    assert(basicBlock != NULL);
+
+    basicBlocks_.push_back(basicBlock.get());
+    ownedBasicBlocks_.push_back(std::move(basicBlock));
+}
+
+void Function::addSharedBasicBlock(BasicBlock *basicBlock) {
+    assert(basicBlock != NULL);
+
+    basicBlocks_.push_back(basicBlock);
+}
+
+Function::BasicBlockMap Function::unshare() {
+    BasicBlockMap clones;
+
+    if (!hasSharedBasicBlocks()) {
+        return clones;
+    }
+
+    boost::unordered_set<const BasicBlock *> owned;
+    foreach (const auto &basicBlock, ownedBasicBlocks_) {
+        owned.insert(basicBlock.get());
+    }
+
+    foreach (BasicBlock *&basicBlock, basicBlocks_) {
+        if (!nc::contains(owned, basicBlock)) {
+            auto clone = basicBlock->clone();
+            clones[basicBlock] = clone.get();
+            basicBlock = clone.get();
+            ownedBasicBlocks_.push_back(std::move(clone));
+        }
+    }
+
+    auto updateJumpTarget = [&](JumpTarget &target) {
+        if (target.basicBlock()) {
+            if (BasicBlock *clone = nc::find(clones, target.basicBlock())) {
+                target.setBasicBlock(clone);
+            }
+        }
+        if (target.table()) {
+            foreach (JumpTableEntry &entry, *target.table()) {
+                if (BasicBlock *clone = nc::find(clones, entry.basicBlock())) {
+                    entry.setBasicBlock(clone);
+                }
+            }
+        }
+    };
+
+    foreach (BasicBlock *basicBlock, basicBlocks_) {
+        if (Jump *jump = basicBlock->getJump()) {
+            updateJumpTarget(jump->thenTarget());
+            updateJumpTarget(jump->elseTarget());
+        }
+    }
+
+    if (entry_) {
+        if (BasicBlock *clone = nc::find(clones, entry_)) {
+            entry_ = clone;
+        }
+    }
+
+    return clones;
 }
 
 bool Function::isEmpty() const {
@@ -29,6 +29,7 @@
 #include <QString>
 
 #include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <nc/common/Printable.h>
 
@@ -45,7 +46,8 @@ class BasicBlock;
  */
 class Function: public PrintableBase<Function>, boost::noncopyable {
     BasicBlock *entry_; ///< Entry basic block.
-    std::vector<std::unique_ptr<BasicBlock>> basicBlocks_; ///< All basic blocks of the function.
+    std::vector<BasicBlock *> basicBlocks_; ///< All basic blocks of the function.
+    std::vector<std::unique_ptr<BasicBlock>> ownedBasicBlocks_; ///< Basic blocks owned by the function.
     QString name_; ///< Name of this function.
     CommentText comment_; ///< Comment to be displayed before a definition or declaration of this function.
 
@@ -78,9 +80,7 @@ public:
     /**
      * \return All basic blocks of the function.
      */
-    const std::vector<BasicBlock *> &basicBlocks() {
-        return reinterpret_cast<const std::vector<BasicBlock *> &>(basicBlocks_);
-    }
+    const std::vector<BasicBlock *> &basicBlocks() { return basicBlocks_; }
 
     /**
      * \return All basic blocks of the function.
@@ -90,12 +90,40 @@ public:
     }
 
     /**
-     * Adds basic block to the function. The function doesn't have ownership of basic blocks.
+     * Adds basic block to the function. The function takes ownership of it.
      *
-     * \param basicBlock Basic block.
+     * \param basicBlock Valid pointer to the basic block.
      */
     void addBasicBlock(std::unique_ptr<BasicBlock> basicBlock);
 
+    /**
+     * Adds basic block owned by someone else, normally the program, to the function.
+     * Such a basic block can belong to several functions at once, and must not
+     * be modified: call unshare() first if the function's code needs changes.
+     *
+     * \param basicBlock Valid pointer to the basic block.
+     */
+    void addSharedBasicBlock(BasicBlock *basicBlock);
+
+    /**
+     * \return True iff some basic blocks of the function are not owned by it.
+     */
+    bool hasSharedBasicBlocks() const { return ownedBasicBlocks_.size() != basicBlocks_.size(); }
+
+    /**
+     * Mapping from basic blocks to basic blocks.
+     */
+    typedef boost::unordered_map<const BasicBlock *, BasicBlock *> BasicBlockMap;
+
+    /**
+     * Replaces all shared basic blocks of the function by the clones owned by it.
+     * Jumps of the function's basic blocks and the entry are redirected to the clones.
+     * This is what passes modifying the function's code must do first.
+     *
+     * \return Mapping of the replaced basic blocks to their clones.
+     */
+    BasicBlockMap unshare();
+
     /**
      * \return True iff this function has no statements in its basic blocks.
      */
@@ -22,7 +22,6 @@
 #include "FunctionsGenerator.h"
 
 #include <boost/range/adaptor/map.hpp>
-#include <boost/unordered_set.hpp>
 
 #include <nc/common/Foreach.h>
 #include <nc/common/Range.h>
@@ -43,18 +42,40 @@ namespace ir {
 
 namespace {
 
+/**
+ * Visits in depth-first order all the not yet visited basic blocks
+ * reachable from the given one.
+ *
+ * \param[in] cfg Control flow graph.
+ * \param[in] index Index of the start basic block in the graph.
+ * \param visited Bit vector of visited basic blocks, indexed like the graph.
+ * \param[out] trace Vector to append the visited basic blocks to, in preorder.
+ */
 void dfs(
     const CFG &cfg,
-    const BasicBlock *basicBlock,
-    boost::unordered_set<const BasicBlock *> &visited,
+    std::size_t index,
+    std::vector<bool> &visited,
     std::vector<const BasicBlock *> &trace)
 {
-    visited.insert(basicBlock);
-    trace.push_back(basicBlock);
-
-    foreach (const BasicBlock *successor, cfg.getSuccessors(basicBlock)) {
-        if (visited.find(successor) == visited.end()) {
-            dfs(cfg, successor, visited, trace);
+    /* Explicit DFS stack: index of a basic block and the position of its next successor to visit. */
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+
+    visited[index] = true;
+    trace.push_back(cfg.getBasicBlock(index));
+    stack.push_back(std::make_pair(index, 0));
+
+    while (!stack.empty()) {
+        CFG::IndexRange successors = cfg.getSuccessorIndices(stack.back().first);
+
+        if (stack.back().second < static_cast<std::size_t>(successors.size())) {
+            std::size_t successor = successors[stack.back().second++];
+            if (!visited[successor]) {
+                visited[successor] = true;
+                trace.push_back(cfg.getBasicBlock(successor));
+                stack.push_back(std::make_pair(successor, 0));
+            }
+        } else {
+            stack.pop_back();
         }
     }
 }
@@ -62,28 +83,54 @@ void dfs(
 } // anonymous namespace
 
 void FunctionsGenerator::makeFunctions(const Program &program, Functions &functions) const {
-    boost::unordered_set<const BasicBlock *> processed;
-
     CFG cfg(program.basicBlocks());
 
-    /* Generate all functions being called. Create even empty ones. */
-    foreach (const BasicBlock *basicBlock, program.basicBlocks()) {
-        if (basicBlock->address() && program.isCalledAddress(*basicBlock->address())) {
-            boost::unordered_set<const BasicBlock *> visited;
-            std::vector<const BasicBlock *> trace;
+    /* Basic blocks included into some function. */
+    std::vector<bool> processed(cfg.size());
+
+    /* Stubs do not become functions, nor parts of them. */
+    if (stubs_) {
+        for (std::size_t i = 0; i < cfg.size(); ++i) {
+            const BasicBlock *basicBlock = cfg.getBasicBlock(i);
+            if (basicBlock->address() && nc::contains(*stubs_, *basicBlock->address())) {
+                processed[i] = true;
+            }
+        }
+    }
 
-            dfs(cfg, basicBlock, visited, trace);
-            functions.addFunction(makeFunction(trace, basicBlock));
-            processed.insert(trace.begin(), trace.end());
+    /* Generate all functions being called. Create even empty ones. */
+    {
+        /* Functions being called can share basic blocks, so each gets a fresh visited set. */
+        std::vector<bool> visited(cfg.size());
+
+        for (std::size_t i = 0; i < cfg.size(); ++i) {
+            const BasicBlock *basicBlock = cfg.getBasicBlock(i);
+
+            if (basicBlock->address() && program.isCalledAddress(*basicBlock->address()) &&
+                !(stubs_ && nc::contains(*stubs_, *basicBlock->address())))
+            {
+                std::vector<const BasicBlock *> trace;
+
+                dfs(cfg, i, visited, trace);
+                functions.addFunction(makeFunction(trace, basicBlock));
+
+                foreach (const BasicBlock *visitedBasicBlock, trace) {
+                    std::size_t index = cfg.getIndex(visitedBasicBlock);
+                    visited[index] = false;
+                    processed[index] = true;
+                }
+            }
         }
     }
 
     /* Single out all other possible functions. */
-    foreach (const BasicBlock *basicBlock, program.basicBlocks()) {
-        if (basicBlock->address() && cfg.getPredecessors(basicBlock).empty() && !contains(processed, basicBlock)) {
+    for (std::size_t i = 0; i < cfg.size(); ++i) {
+        const BasicBlock *basicBlock = cfg.getBasicBlock(i);
+
+        if (basicBlock->address() && cfg.getPredecessorIndices(i).empty() && !processed[i]) {
             std::vector<const BasicBlock *> trace;
 
-            dfs(cfg, basicBlock, processed, trace);
+            dfs(cfg, i, processed, trace);
 
             auto function = makeFunction(trace, basicBlock);
             if (!function->isEmpty()) {
@@ -93,11 +140,13 @@ void FunctionsGenerator::makeFunctions(const Program &program, Functions &functi
     }
 
     /* Single out remaining weird strongly connected components. */
-    foreach (const BasicBlock *basicBlock, program.basicBlocks()) {
-        if (basicBlock->address() && !contains(processed, basicBlock)) {
+    for (std::size_t i = 0; i < cfg.size(); ++i) {
+        const BasicBlock *basicBlock = cfg.getBasicBlock(i);
+
+        if (basicBlock->address() && !processed[i]) {
             std::vector<const BasicBlock *> trace;
 
-            dfs(cfg, basicBlock, processed, trace);
+            dfs(cfg, i, processed, trace);
 
             auto function = makeFunction(trace, basicBlock);
             if (!function->isEmpty()) {
@@ -113,15 +162,19 @@ std::unique_ptr<Function> FunctionsGenerator::makeFunction(const std::vector<con
     /* Create a new function. */
     std::unique_ptr<Function> function(new Function);
 
-    /* Clone basic blocks into it. */
-    auto clones = cloneIntoFunction(basicBlocks, function.get());
+    /*
+     * Share the basic blocks with the program and other functions instead of
+     * cloning them. Jump targets inside the basic blocks stay valid, as the
+     * blocks are taken together with all their successors.
+     */
+    foreach (const BasicBlock *basicBlock, basicBlocks) {
+        function->addSharedBasicBlock(const_cast<BasicBlock *>(basicBlock));
+    }
 
     /* Set the entry basic block. */
     if (entry) {
-        BasicBlock *clonedEntry = nc::find(clones, entry);
-        assert(clonedEntry != NULL && "Entry must have been cloned.");
-
-        function->setEntry(clonedEntry);
+        assert(nc::contains(basicBlocks, entry) && "Entry must belong to the function.");
+        function->setEntry(const_cast<BasicBlock *>(entry));
     }
 
     return function;
@@ -22,11 +22,14 @@
 
 #include <nc/config.h>
 
+#include <map>
 #include <memory>
 #include <vector>
 
 #include <boost/unordered_map.hpp>
 
+#include <nc/common/Types.h>
+
 namespace nc {
 namespace core {
 namespace ir {
@@ -40,13 +43,31 @@ class Program;
  * Generator of functions from control flow graph.
  */
 class FunctionsGenerator {
+    /** Mapping from the addresses of stubs to the addresses of their slots. */
+    const std::map<ByteAddr, ByteAddr> *stubs_;
+
     public:
 
+    /**
+     * Constructor.
+     */
+    FunctionsGenerator(): stubs_(NULL) {}
+
     /**
      * Virtual destructor.
      */
     virtual ~FunctionsGenerator() {}
 
+    /**
+     * Sets the stubs jumping through memory slots, like PLT entries.
+     * No functions are created for them: calls to a stub are analyzed
+     * as calls through its slot.
+     *
+     * \param stubs Pointer to the mapping from the addresses of stubs
+     *              to the addresses of their slots. Can be NULL.
+     */
+    void setStubs(const std::map<ByteAddr, ByteAddr> *stubs) { stubs_ = stubs; }
+
     /**
      * Discovers functions in the control flow graph and 
      *
@@ -57,6 +78,9 @@ class FunctionsGenerator {
 
     /**
      * Creates a function out of a set of nodes and, optionally, entry basic block.
+     * The function shares the basic blocks with their owner and other functions
+     * built from them (see Function::addSharedBasicBlock()). The set must be
+     * closed under the successor relation.
      *
      * \param[in] nodes Nodes belonging to a function.
      * \param[in] entry Entry basic block of a function, if known.
@@ -21,10 +21,50 @@
 
 #include "Statement.h"
 
+#include <cassert>
+
+#ifdef NC_USE_THREADS
+#include <QAtomicInt>
+#endif
+
+#include <nc/common/ObjectPool.h>
+
 namespace nc {
 namespace core {
 namespace ir {
 
+namespace {
+
+/** Pool the statements are allocated from. */
+ObjectPool *const statementPool = new ObjectPool();
+
+/** Identifier of the next statement. */
+#ifdef NC_USE_THREADS
+QAtomicInt nextStatementId;
+#else
+int nextStatementId = 0;
+#endif
+
+} // anonymous namespace
+
+unsigned Statement::allocateId() {
+#ifdef NC_USE_THREADS
+    int result = nextStatementId.fetchAndAddRelaxed(1);
+#else
+    int result = nextStatementId++;
+#endif
+    assert(result >= 0 && "Statement identifiers overflowed.");
+    return static_cast<unsigned>(result);
+}
+
+void *Statement::operator new(std::size_t size) {
+    return statementPool->allocate(size);
+}
+
+void Statement::operator delete(void *pointer, std::size_t size) {
+    statementPool->deallocate(pointer, size);
+}
+
 std::unique_ptr<Statement> Statement::clone() const {
     std::unique_ptr<Statement> result(doClone());
 
@@ -77,6 +77,7 @@ public:
     };
 
 private:
+    unsigned id_; ///< Identifier of this statement.
     BasicBlock *basicBlock_; ///< Basic block this statement is a part of.
     const arch::Instruction *instruction_; ///< Instruction from which this statement was generated.
 
@@ -86,7 +87,15 @@ public:
      *
      * \param[in] kind Kind of the statement.
      */
-    Statement(int kind): kind_(kind), basicBlock_(NULL), instruction_(NULL) {}
+    Statement(int kind): kind_(kind), id_(allocateId()), basicBlock_(NULL), instruction_(NULL) {}
+
+    /**
+     * Statements are numbered in the order of their creation, starting from zero.
+     * Clones get new identifiers.
+     *
+     * \return Identifier of this statement.
+     */
+    unsigned id() const { return id_; }
 
     /**
      * \return Basic block that this statement is a part of.
@@ -130,6 +139,23 @@ public:
      */
     std::unique_ptr<Statement> clone() const;
 
+    /**
+     * Allocates memory for a statement from the pool shared by all statements.
+     *
+     * \param size Size of the object.
+     *
+     * \return Valid pointer to the memory.
+     */
+    static void *operator new(std::size_t size);
+
+    /**
+     * Returns the memory of a statement to the pool.
+     *
+     * \param pointer Pointer to the memory. Can be NULL.
+     * \param size Size of the object.
+     */
+    static void operator delete(void *pointer, std::size_t size);
+
     inline bool isComment() const;
     inline bool isInlineAssembly() const;
     inline bool isAssignment() const;
@@ -147,6 +173,12 @@ public:
     inline const Call *asCall() const;
     inline const Return *asReturn() const;
     
+private:
+    /**
+     * \return Identifier for a new statement.
+     */
+    static unsigned allocateId();
+
 protected:
     /**
      * Actually clones the statement.
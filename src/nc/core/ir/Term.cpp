@@ -21,12 +21,52 @@
 
 #include "Term.h"
 
+#include <cassert>
+
+#ifdef NC_USE_THREADS
+#include <QAtomicInt>
+#endif
+
+#include <nc/common/ObjectPool.h>
+
 #include "Statement.h"
 
 namespace nc { namespace core { namespace ir {
 
 namespace {
 
+/** Pool the terms are allocated from. */
+ObjectPool *const termPool = new ObjectPool();
+
+/** Identifier of the next term. */
+#ifdef NC_USE_THREADS
+QAtomicInt nextTermId;
+#else
+int nextTermId = 0;
+#endif
+
+} // anonymous namespace
+
+unsigned Term::allocateId() {
+#ifdef NC_USE_THREADS
+    int result = nextTermId.fetchAndAddRelaxed(1);
+#else
+    int result = nextTermId++;
+#endif
+    assert(result >= 0 && "Term identifiers overflowed.");
+    return static_cast<unsigned>(result);
+}
+
+void *Term::operator new(std::size_t size) {
+    return termPool->allocate(size);
+}
+
+void Term::operator delete(void *pointer, std::size_t size) {
+    termPool->deallocate(pointer, size);
+}
+
+namespace {
+
 class SetStatementVisitor: public Visitor<Term> {
     const Statement *statement_;
 
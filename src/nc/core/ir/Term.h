@@ -89,6 +89,8 @@ private:
     bool isWrite_; ///< Term is written.
     bool isKill_; ///< Term is killed.
 
+    unsigned id_; ///< Identifier of this term.
+
     Term *assignee_; ///< RHS of assignment operator, whose LHS is this term.
 
     const Statement *statement_; ///< Statement that this term belongs to.
@@ -103,7 +105,7 @@ public:
     Term(int kind, SmallBitSize size):
         kind_(kind), size_(size),
         isRead_(false), isWrite_(false), isKill_(false),
-        assignee_(0), statement_(NULL)
+        id_(allocateId()), assignee_(0), statement_(NULL)
     {
         assert(size != 0);
     }
@@ -131,6 +133,15 @@ public:
      */
     SmallBitSize size() const { return size_; }
 
+    /**
+     * Terms are numbered in the order of their creation, starting from zero.
+     * Terms created close in time, e.g. the terms of one instruction or of
+     * one call analyzer, get close identifiers. Clones get new identifiers.
+     *
+     * \returns                        Identifier of this term.
+     */
+    unsigned id() const { return id_; }
+
     /**
      * \return                         True, if term is used for reading.
      */
@@ -181,6 +192,23 @@ public:
      */
     std::unique_ptr<Term> clone() const { return std::unique_ptr<Term>(doClone()); }
 
+    /**
+     * Allocates memory for a term from the pool shared by all terms.
+     *
+     * \param size Size of the object.
+     *
+     * \return Valid pointer to the memory.
+     */
+    static void *operator new(std::size_t size);
+
+    /**
+     * Returns the memory of a term to the pool.
+     *
+     * \param pointer Pointer to the memory. Can be NULL.
+     * \param size Size of the object.
+     */
+    static void operator delete(void *pointer, std::size_t size);
+
     inline bool isConstant() const;
     inline bool isIntrinsic() const;
     inline bool isMemoryLocationAccess() const;
@@ -199,6 +227,12 @@ public:
     inline const BinaryOperator *asBinaryOperator() const;
     inline const Choice *asChoice() const;
 
+private:
+    /**
+     * \return                         Identifier for a new term.
+     */
+    static unsigned allocateId();
+
 protected:
     /**
      * \returns                        Whether this term's flags were initialized.
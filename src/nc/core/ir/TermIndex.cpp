@@ -0,0 +1,84 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "TermIndex.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Term.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+
+namespace {
+
+/**
+ * Orders pages by their numbers.
+ */
+struct PageLess {
+    bool operator()(const std::pair<unsigned, unsigned> &page, unsigned number) const {
+        return page.first < number;
+    }
+};
+
+} // anonymous namespace
+
+std::size_t TermIndex::find(const Term *term) const {
+    assert(term != NULL);
+
+    unsigned pageNumber = static_cast<unsigned>(term->id() / PAGE_SIZE);
+
+    auto page = std::lower_bound(pages_.begin(), pages_.end(), pageNumber, PageLess());
+    if (page == pages_.end() || page->first != pageNumber) {
+        return NOT_FOUND;
+    }
+
+    unsigned entry = entries_[page->second + term->id() % PAGE_SIZE];
+    return entry ? entry - 1 : NOT_FOUND;
+}
+
+std::pair<std::size_t, bool> TermIndex::insert(const Term *term) {
+    assert(term != NULL);
+
+    unsigned pageNumber = static_cast<unsigned>(term->id() / PAGE_SIZE);
+
+    auto page = std::lower_bound(pages_.begin(), pages_.end(), pageNumber, PageLess());
+    if (page == pages_.end() || page->first != pageNumber) {
+        page = pages_.insert(page, std::make_pair(pageNumber, static_cast<unsigned>(entries_.size())));
+        entries_.resize(entries_.size() + PAGE_SIZE, 0);
+    }
+
+    unsigned &entry = entries_[page->second + term->id() % PAGE_SIZE];
+    if (entry) {
+        return std::make_pair(std::size_t(entry - 1), false);
+    }
+
+    entry = static_cast<unsigned>(++size_);
+    return std::make_pair(size_ - 1, true);
+}
+
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,99 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class Term;
+
+/**
+ * Numbers terms densely, in the order they are added.
+ *
+ * Containers of per-term information, e.g. the results of dataflow analysis
+ * of a function, keep the information in arrays indexed by these numbers.
+ * The number of a term is found by the term's identifier in pages of
+ * PAGE_SIZE numbers, created only for the ranges of identifiers in use.
+ * Terms of one function have close identifiers, so a few pages suffice,
+ * and a lookup is a binary search over them followed by an indexed load.
+ */
+class TermIndex {
+    public:
+
+    /** Number of consecutive term identifiers covered by a page. */
+    static const std::size_t PAGE_SIZE = 64;
+
+    /** Value returned by find() for terms that were not added. */
+    static const std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+    private:
+
+    /** Pairs of a page number and the offset of the page in entries_, sorted by page numbers. */
+    std::vector<std::pair<unsigned, unsigned> > pages_;
+
+    /** Numbers of the terms plus one, zero for terms not added. */
+    std::vector<unsigned> entries_;
+
+    /** Number of added terms. */
+    std::size_t size_;
+
+    public:
+
+    /**
+     * Constructor.
+     */
+    TermIndex(): size_(0) {}
+
+    /**
+     * \return Number of added terms.
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * \param[in] term Valid pointer to a term.
+     *
+     * \return Number of the term, or NOT_FOUND if the term was not added.
+     */
+    std::size_t find(const Term *term) const;
+
+    /**
+     * Adds a term, unless it was added before.
+     *
+     * \param[in] term Valid pointer to a term.
+     *
+     * \return Pair of the number of the term and a flag that is true
+     *         iff the term was added by this call.
+     */
+    std::pair<std::size_t, bool> insert(const Term *term);
+};
+
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -23,6 +23,8 @@
 
 #include <cassert>
 
+#include <QMutexLocker>
+
 #include <nc/common/Foreach.h>
 #include <nc/common/Range.h>
 
@@ -44,7 +46,7 @@ namespace core {
 namespace ir {
 namespace calls {
 
-CallsData::CallsData(): callingConventionDetector_(NULL) {}
+CallsData::CallsData(): mutex_(QMutex::Recursive), callingConventionDetector_(NULL) {}
 
 CallsData::~CallsData() {}
 
@@ -58,11 +60,17 @@ FunctionDescriptor CallsData::getDescriptor(const Function *function) const {
     }
 }
 
-FunctionDescriptor CallsData::getDescriptor(const Call *call) const {
+FunctionDescriptor CallsData::getDescriptor(const Function *function, const Call *call) const {
     assert(call != NULL);
 
-    if (auto addr = getCalledAddress(call)) {
+    if (auto addr = getCalledAddress(function, call)) {
+        QMutexLocker locker(&mutex_);
+        if (auto slot = nc::find_optional(stub2slot_, *addr)) {
+            return FunctionDescriptor(FunctionDescriptor::SLOT_ADDRESS, *slot);
+        }
         return FunctionDescriptor(FunctionDescriptor::ENTRY_ADDRESS, *addr);
+    } else if (auto addr = getSlotAddress(function, call)) {
+        return FunctionDescriptor(FunctionDescriptor::SLOT_ADDRESS, *addr);
     } else if (call->instruction()) {
         return FunctionDescriptor(FunctionDescriptor::CALL_ADDRESS, call->instruction()->addr());
     } else {
@@ -70,25 +78,55 @@ FunctionDescriptor CallsData::getDescriptor(const Call *call) const {
     }
 }
 
-boost::optional<ByteAddr> CallsData::getCalledAddress(const Call *call) const {
+boost::optional<ByteAddr> CallsData::getCalledAddress(const Function *function, const Call *call) const {
+    assert(call != NULL);
+
+    QMutexLocker locker(&mutex_);
+
+    return nc::find_optional(call2address_, std::make_pair(function, call));
+}
+
+void CallsData::setCalledAddress(const Function *function, const Call *call, ByteAddr addr) {
+    assert(call != NULL);
+
+    QMutexLocker locker(&mutex_);
+
+    call2address_[std::make_pair(function, call)] = addr;
+}
+
+boost::optional<ByteAddr> CallsData::getSlotAddress(const Function *function, const Call *call) const {
     assert(call != NULL);
 
-    return nc::find_optional(call2address_, call);
+    QMutexLocker locker(&mutex_);
+
+    return nc::find_optional(call2slot_, std::make_pair(function, call));
 }
 
-void CallsData::setCalledAddress(const Call *call, ByteAddr addr) {
+void CallsData::setSlotAddress(const Function *function, const Call *call, ByteAddr addr) {
     assert(call != NULL);
 
-    call2address_[call] = addr;
+    QMutexLocker locker(&mutex_);
+
+    call2slot_[std::make_pair(function, call)] = addr;
+}
+
+void CallsData::setStubSlot(ByteAddr stubAddress, ByteAddr slotAddress) {
+    QMutexLocker locker(&mutex_);
+
+    stub2slot_[stubAddress] = slotAddress;
 }
 
 void CallsData::setCallingConvention(const FunctionDescriptor &descriptor, const CallingConvention *convention) {
+    QMutexLocker locker(&mutex_);
+
     assert(nc::find(descriptor2convention_, descriptor) == NULL && "Calling convention cannot be reset.");
 
     descriptor2convention_[descriptor] = convention;
 }
 
 const CallingConvention *CallsData::getCallingConvention(const FunctionDescriptor &descriptor) {
+    QMutexLocker locker(&mutex_);
+
     if (!descriptor) {
         return NULL;
     }
@@ -101,6 +139,8 @@ const CallingConvention *CallsData::getCallingConvention(const FunctionDescripto
 }
 
 DescriptorAnalyzer *CallsData::getDescriptorAnalyzer(const FunctionDescriptor &descriptor) {
+    QMutexLocker locker(&mutex_);
+
     if (!descriptor) {
         return NULL;
     }
@@ -115,6 +155,8 @@ DescriptorAnalyzer *CallsData::getDescriptorAnalyzer(const FunctionDescriptor &d
 FunctionAnalyzer *CallsData::getFunctionAnalyzer(const Function *function) {
     assert(function != NULL);
 
+    QMutexLocker locker(&mutex_);
+
     FunctionDescriptor descriptor = getDescriptor(function);
     if (!descriptor) {
         return NULL;
@@ -129,15 +171,17 @@ FunctionAnalyzer *CallsData::getFunctionAnalyzer(const Function *function) {
     return nc::find(function2analyzer_, key).get();
 }
 
-CallAnalyzer *CallsData::getCallAnalyzer(const Call *call) {
+CallAnalyzer *CallsData::getCallAnalyzer(const Function *function, const Call *call) {
     assert(call != NULL);
 
-    FunctionDescriptor descriptor = getDescriptor(call);
+    QMutexLocker locker(&mutex_);
+
+    FunctionDescriptor descriptor = getDescriptor(function, call);
     if (!descriptor) {
         return NULL;
     }
 
-    auto key = std::make_pair(descriptor, call);
+    auto key = std::make_pair(descriptor, std::make_pair(function, call));
     if (!nc::contains(call2analyzer_, key)) {
         if (DescriptorAnalyzer *descriptorAnalyzer = getDescriptorAnalyzer(descriptor)) {
             call2analyzer_[key] = descriptorAnalyzer->createCallAnalyzer(call);
@@ -149,12 +193,14 @@ CallAnalyzer *CallsData::getCallAnalyzer(const Call *call) {
 ReturnAnalyzer *CallsData::getReturnAnalyzer(const Function *function, const Return *ret) {
     assert(ret != NULL);
 
+    QMutexLocker locker(&mutex_);
+
     FunctionDescriptor descriptor = getDescriptor(function);
     if (!descriptor) {
         return NULL;
     }
 
-    auto key = std::make_pair(descriptor, ret);
+    auto key = std::make_pair(descriptor, std::make_pair(function, ret));
     if (!nc::contains(return2analyzer_, key)) {
         if (DescriptorAnalyzer *addressAnalyzer = getDescriptorAnalyzer(descriptor)) {
             return2analyzer_[key] = addressAnalyzer->createReturnAnalyzer(ret);
@@ -164,6 +210,8 @@ ReturnAnalyzer *CallsData::getReturnAnalyzer(const Function *function, const Ret
 }
 
 const FunctionSignature *CallsData::getFunctionSignature(const FunctionDescriptor &descriptor) {
+    QMutexLocker locker(&mutex_);
+
     if (!descriptor) {
         return NULL;
     }
@@ -179,8 +227,8 @@ const FunctionSignature *CallsData::getFunctionSignature(const Function *functio
     return getFunctionSignature(getDescriptor(function));
 }
 
-const FunctionSignature *CallsData::getFunctionSignature(const Call *call) {
-    return getFunctionSignature(getDescriptor(call));
+const FunctionSignature *CallsData::getFunctionSignature(const Function *function, const Call *call) {
+    return getFunctionSignature(getDescriptor(function, call));
 }
 
 std::vector<const Return *> CallsData::getReturns(const Function *function) const {
@@ -27,6 +27,8 @@
 #include <boost/optional.hpp>
 #include <boost/unordered_map.hpp>
 
+#include <QMutex>
+
 #include <nc/common/Types.h>
 
 #include "FunctionDescriptor.h"
@@ -51,13 +53,33 @@ class ReturnAnalyzer;
 
 /**
  * Information about how functions call each other.
+ *
+ * Member functions of this class can be called concurrently from several threads.
+ * The call, function, and return analyzers returned by it are not synchronized:
+ * each of them must be used only by the thread analyzing the function
+ * owning the corresponding call, function, or return.
  */
 class CallsData {
+    /** Mutex guarding all the mappings. Recursive, as the calling convention detector calls back. */
+    mutable QMutex mutex_;
+
     /** Detector of calling conventions. */
     const CallingConventionDetector *callingConventionDetector_;
 
-    /** Mapping from a call to its destination address. */
-    boost::unordered_map<const Call *, ByteAddr> call2address_;
+    /**
+     * Mapping from a call in a function to its destination address.
+     * Basic blocks can be shared by functions, hence the function is a part of the key.
+     */
+    boost::unordered_map<std::pair<const Function *, const Call *>, ByteAddr> call2address_;
+
+    /**
+     * Mapping from a call in a function to the address of the memory slot
+     * the destination address is loaded from, for calls with unknown destinations.
+     */
+    boost::unordered_map<std::pair<const Function *, const Call *>, ByteAddr> call2slot_;
+
+    /** Mapping from the address of a stub to the address of the slot it jumps through. */
+    boost::unordered_map<ByteAddr, ByteAddr> stub2slot_;
 
     /** Mapping from a function's descriptor to the associated calling convention. */
     boost::unordered_map<FunctionDescriptor, const CallingConvention *> descriptor2convention_;
@@ -68,11 +90,17 @@ class CallsData {
     /** Mapping from a function to its analyzer. */
     boost::unordered_map<std::pair<FunctionDescriptor, const Function *>, std::unique_ptr<FunctionAnalyzer>> function2analyzer_;
 
-    /** Mapping from a call to its analyzer. */
-    boost::unordered_map<std::pair<FunctionDescriptor, const Call *>, std::unique_ptr<CallAnalyzer>> call2analyzer_;
+    /**
+     * Mapping from a call in a function to its analyzer.
+     * Basic blocks can be shared by functions, hence the function is a part of the key.
+     */
+    boost::unordered_map<std::pair<FunctionDescriptor, std::pair<const Function *, const Call *>>, std::unique_ptr<CallAnalyzer>> call2analyzer_;
 
-    /** Mapping from a return to its analyzer. */
-    boost::unordered_map<std::pair<FunctionDescriptor, const Return *>, std::unique_ptr<ReturnAnalyzer>> return2analyzer_;
+    /**
+     * Mapping from a return in a function to its analyzer.
+     * Basic blocks can be shared by functions, hence the function is a part of the key.
+     */
+    boost::unordered_map<std::pair<FunctionDescriptor, std::pair<const Function *, const Return *>>, std::unique_ptr<ReturnAnalyzer>> return2analyzer_;
 
     /** Mapping from a function's descriptor to its signature. */
     boost::unordered_map<FunctionDescriptor, std::unique_ptr<FunctionSignature>> descriptor2signature_;
@@ -109,26 +137,60 @@ class CallsData {
     FunctionDescriptor getDescriptor(const Function *function) const;
 
     /**
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
      * \param call Valid pointer to a call.
      *
      * \return Descriptor of the called function.
      */
-    FunctionDescriptor getDescriptor(const Call *call) const;
+    FunctionDescriptor getDescriptor(const Function *function, const Call *call) const;
 
     /**
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
      * \param call Valid pointer to a Call instance.
      *
-     * \return Address this call is a call to.
+     * \return Address this call is a call to, as computed in the given function.
      */
-    boost::optional<ByteAddr> getCalledAddress(const Call *call) const;
+    boost::optional<ByteAddr> getCalledAddress(const Function *function, const Call *call) const;
 
     /**
      * Sets the destination address of a call.
      *
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
      * \param call Valid pointer to a Call instance.
      * \param addr New destination address of the call.
      */
-    void setCalledAddress(const Call *call, ByteAddr addr);
+    void setCalledAddress(const Function *function, const Call *call, ByteAddr addr);
+
+    /**
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
+     * \param call Valid pointer to a Call instance.
+     *
+     * \return Address of the memory slot the destination address of this call
+     *         is loaded from, as computed in the given function.
+     */
+    boost::optional<ByteAddr> getSlotAddress(const Function *function, const Call *call) const;
+
+    /**
+     * Sets the address of the memory slot the destination address of a call is loaded from.
+     * Calls through the same slot, e.g. the same import address table entry,
+     * share the descriptor and, therefore, the signature, unless their
+     * destination addresses are known.
+     *
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
+     * \param call Valid pointer to a Call instance.
+     * \param addr Address of the slot.
+     */
+    void setSlotAddress(const Function *function, const Call *call, ByteAddr addr);
+
+    /**
+     * Remembers that the code at the given address only jumps to the address
+     * stored in the given slot, like a PLT entry does. Calls to such a stub
+     * get the same descriptor as calls through the slot.
+     *
+     * \param stubAddress Address of the stub.
+     * \param slotAddress Address of the slot.
+     */
+    void setStubSlot(ByteAddr stubAddress, ByteAddr slotAddress);
 
     /**
      * Sets function's calling convention.
@@ -161,12 +223,13 @@ class CallsData {
     FunctionAnalyzer *getFunctionAnalyzer(const Function *function);
 
     /**
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
      * \param call Valid pointer to a call statement.
      *
      * \return Pointer to a CallAnalyzer instance for this call statement.
      * Can be NULL. Such instance is created when necessary and if possible.
      */
-    CallAnalyzer *getCallAnalyzer(const Call *call);
+    CallAnalyzer *getCallAnalyzer(const Function *function, const Call *call);
 
     /**
      * \param function Valid pointer to a function.
@@ -194,9 +257,10 @@ class CallsData {
     /**
      * \return Pointer to the signature of the function being called. Can be NULL.
      *
+     * \param function Pointer to the function the call is analyzed in. Can be NULL.
      * \param call Valid pointer to the call.
      */
-    const FunctionSignature *getFunctionSignature(const Call *call);
+    const FunctionSignature *getFunctionSignature(const Function *function, const Call *call);
 
     /**
      * \param function Valid pointer to a function.
@@ -43,7 +43,8 @@ class FunctionDescriptor {
     enum Kind {
         INVALID,       ///< Invalid descriptor not identifying anything.
         ENTRY_ADDRESS, ///< Identifier by function's entry address.
-        CALL_ADDRESS   ///< Identifier by the call instruction address.
+        CALL_ADDRESS,  ///< Identifier by the call instruction address.
+        SLOT_ADDRESS   ///< Identifier by the address of the memory slot holding the function's address, e.g. an import address table entry.
     };
 
     private:
@@ -62,12 +63,12 @@ class FunctionDescriptor {
      * Constructor.
      *
      * \param kind Kind of the descriptor.
-     * \param address Function's entry or call instruction address (depends on the kind).
+     * \param address Function's entry, call instruction, or slot address (depends on the kind).
      */
     FunctionDescriptor(Kind kind, ByteAddr address):
         kind_(kind), address_(address)
     {
-        assert(kind == ENTRY_ADDRESS || kind == CALL_ADDRESS);
+        assert(kind == ENTRY_ADDRESS || kind == CALL_ADDRESS || kind == SLOT_ADDRESS);
     }
 
     /**
@@ -85,6 +86,12 @@ class FunctionDescriptor {
      */
     const ByteAddr *callAddress() const { return kind_ == CALL_ADDRESS ? &address_ : NULL; }
 
+    /**
+     * \return Valid pointer to the address of the slot the function's address is loaded from,
+     *         if kind is SLOT_ADDRESS, or NULL otherwise.
+     */
+    const ByteAddr *slotAddress() const { return kind_ == SLOT_ADDRESS ? &address_ : NULL; }
+
     /**
      * \return True if this is equal to that, false otherwise.
      */
@@ -187,7 +187,7 @@ void GenericCallAnalyzer::simulateCall(dflow::SimulationContext &context) {
     /* If return values can overlap, they kill each other and the following hack is necessary. */
     foreach (const auto &pair, returnValues_) {
         if (const MemoryLocation &memoryLocation = context.analyzer().dataflow().getMemoryLocation(pair.second.get())) {
-            dflow::ReachingDefinitions definitions;
+            dflow::ReachingDefinitions definitions(context.definitions().numbering());
             definitions.addDefinition(memoryLocation, pair.second.get());
             context.definitions().join(definitions);
         }
@@ -28,7 +28,7 @@
 
 #include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/Function.h>
-#include <nc/core/ir/Statement.h>
+#include <nc/core/ir/Statements.h>
 
 #include "FunctionSignature.h"
 #include "GenericCallingConvention.h"
@@ -92,11 +92,27 @@ FunctionSignature GenericDescriptorAnalyzer::getFunctionSignature() const {
      */
     boost::unordered_map<MemoryLocation, Counts> argVotes;
 
-    std::size_t callsCount = callAnalyzers_.size();
-    std::size_t functionsCount = 0;
+    /*
+     * A call in a basic block shared by several functions has an analyzer
+     * per function. Let every call site vote once, for the union of the
+     * argument locations found by its analyzers.
+     */
+    boost::unordered_map<const Call *, std::vector<MemoryLocation> > callArguments;
 
     foreach (GenericCallAnalyzer *callAnalyzer, callAnalyzers_) {
-        foreach (const MemoryLocation &memoryLocation, callAnalyzer->argumentLocations()) {
+        auto &locations = callArguments[callAnalyzer->call()];
+        locations.insert(locations.end(), callAnalyzer->argumentLocations().begin(), callAnalyzer->argumentLocations().end());
+    }
+
+    std::size_t callsCount = callArguments.size();
+    std::size_t functionsCount = 0;
+
+    foreach (auto &pair, callArguments) {
+        std::vector<MemoryLocation> &locations = pair.second;
+        std::sort(locations.begin(), locations.end());
+        locations.erase(std::unique(locations.begin(), locations.end()), locations.end());
+
+        foreach (const MemoryLocation &memoryLocation, locations) {
             ++argVotes[memoryLocation].defs;
         }
     }
@@ -162,13 +178,23 @@ FunctionSignature GenericDescriptorAnalyzer::getFunctionSignature() const {
      */
     boost::unordered_map<const Term *, int> retVotes;
 
+    /* Again, every call and return site votes once. */
+    boost::unordered_map<const Statement *, std::vector<const Term *> > siteReturnValues;
+
     foreach (GenericCallAnalyzer *callAnalyzer, callAnalyzers_) {
-        foreach (const Term *term, callAnalyzer->returnValueLocations()) {
-            ++retVotes[term];
-        }
+        auto &terms = siteReturnValues[callAnalyzer->call()];
+        terms.insert(terms.end(), callAnalyzer->returnValueLocations().begin(), callAnalyzer->returnValueLocations().end());
     }
     foreach (GenericReturnAnalyzer *returnAnalyzer, returnAnalyzers_) {
-        foreach (const Term *term, returnAnalyzer->returnValueLocations()) {
+        auto &terms = siteReturnValues[returnAnalyzer->ret()];
+        terms.insert(terms.end(), returnAnalyzer->returnValueLocations().begin(), returnAnalyzer->returnValueLocations().end());
+    }
+    foreach (auto &pair, siteReturnValues) {
+        std::vector<const Term *> &terms = pair.second;
+        std::sort(terms.begin(), terms.end());
+        terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+        foreach (const Term *term, terms) {
             ++retVotes[term];
         }
     }
@@ -22,15 +22,13 @@
 #include "GraphBuilder.h"
 
 #include <cassert>
-
-#include <boost/unordered_map.hpp>
+#include <vector>
 
 #include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/CFG.h>
 #include <nc/core/ir/Function.h>
 
 #include <nc/common/Foreach.h>
-#include <nc/common/Range.h>
 
 #include "BasicNode.h"
 #include "Graph.h"
@@ -41,35 +39,32 @@ namespace ir {
 namespace cflow {
 
 void GraphBuilder::operator()(Graph &graph, const ir::Function *function) const {
+    (*this)(graph, function, CFG(function->basicBlocks()));
+}
+
+void GraphBuilder::operator()(Graph &graph, const ir::Function *function, const CFG &cfg) const {
     /* Create the root bulk region. */
     graph.setRoot(new Region(graph, Region::UNKNOWN));
 
     /*
-     * Create nodes.
+     * Create nodes, one per basic block, indexed like basic blocks in the CFG.
      */
-    boost::unordered_map<const ir::BasicBlock *, Node *> basicBlock2node;
+    std::vector<Node *> nodes;
+    nodes.reserve(cfg.size());
 
-    foreach (const ir::BasicBlock *basicBlock, function->basicBlocks()) {
+    foreach (const ir::BasicBlock *basicBlock, cfg.basicBlocks()) {
         auto node = new BasicNode(graph, basicBlock);
         graph.root()->addNode(node);
-        basicBlock2node[basicBlock] = node;
+        nodes.push_back(node);
     }
-    graph.root()->setEntry(basicBlock2node[function->entry()]);
+    graph.root()->setEntry(nodes[cfg.getIndex(function->entry())]);
 
     /*
      * Create edges.
      */
-    CFG cfg(function->basicBlocks());
-
-    foreach (const ir::BasicBlock *tailBasicBlock, function->basicBlocks()) {
-        Node *tail = nc::find(basicBlock2node, tailBasicBlock);
-        assert(tail);
-
-        foreach (const ir::BasicBlock *headBasicBlock, cfg.getSuccessors(tailBasicBlock)) {
-            Node *head = nc::find(basicBlock2node, headBasicBlock);
-            assert(head);
-
-            graph.createEdge(tail, head);
+    for (std::size_t i = 0; i < cfg.size(); ++i) {
+        foreach (std::size_t successor, cfg.getSuccessorIndices(i)) {
+            graph.createEdge(nodes[i], nodes[successor]);
         }
     }
 }
@@ -26,6 +26,7 @@ namespace nc {
 namespace core {
 namespace ir {
 
+class CFG;
 class Function;
 
 namespace cflow {
@@ -45,6 +46,15 @@ class GraphBuilder {
      * \param[in] function Function to build control flow graph for.
      */
     void operator()(Graph &graph, const ir::Function *function) const;
+
+    /**
+     * Builds control flow graph.
+     *
+     * \param[out] graph Result graph.
+     * \param[in] function Function to build control flow graph for.
+     * \param[in] cfg Control flow graph of the function's basic blocks.
+     */
+    void operator()(Graph &graph, const ir::Function *function, const CFG &cfg) const;
 };
 
 } // namespace cflow
@@ -22,12 +22,17 @@
 #include "StructureAnalyzer.h"
 
 #include <algorithm>
+#include <memory>
 #include <queue>
+#include <set>
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <nc/common/Foreach.h>
 #include <nc/common/make_unique.h>
+#include <nc/common/Range.h>
+#include <nc/common/Unreachable.h>
 
 #include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/Jump.h>
@@ -53,69 +58,218 @@ void StructureAnalyzer::analyze() {
 }
 
 void StructureAnalyzer::analyze(Region *region) {
-    bool changed;
+    /*
+     * Subregions installed by the caller (e.g. the loop region this
+     * call structures) are the caller's business. Set them aside and
+     * forget the ones installed here when done.
+     */
+    boost::unordered_set<const Region *> outerMultiEntrySubregions;
+    outerMultiEntrySubregions.swap(multiEntrySubregions_);
+
+    /* Kinds of reductions in the order of decreasing priority. */
+    enum {
+        COMPOUND_CONDITION,
+        CYCLIC,
+        BLOCK,
+        CONDITIONAL,
+        SWITCH_OR_HOPELESS_CONDITIONAL,
+        REDUCTION_KIND_COUNT
+    };
 
-    do {
-        changed = false;
+    std::unique_ptr<Dfs> dfs;
 
-        /*
-         * Classify edges, sort nodes topologically.
-         */
-        Dfs dfs(region);
+    /* Nodes in postorder. Slots of reduced nodes are taken by the subregions they form. */
+    std::vector<Node *> postordering;
 
-        /*
-         * Try to reduce various kinds of regions.
-         */
-        foreach (Node *node, dfs.postordering()) {
-            if (reduceCompoundCondition(node)) {
-                changed = true;
-                break;
+    /* Mapping from a node to its index in the postorder. */
+    boost::unordered_map<const Node *, std::size_t> node2index;
+
+    /* Number in DFS preorder of the node at each postorder index. */
+    std::vector<std::size_t> preorderNumbers;
+
+    /* Postorder indices of the targets of back edges, i.e. of loop entries. */
+    std::vector<std::size_t> loopEntries;
+
+    /* For each kind of reduction, postorder indices of the nodes to try it on. */
+    std::vector<std::set<std::size_t> > worklists(REDUCTION_KIND_COUNT);
+
+    /*
+     * Classifies edges, sorts nodes topologically, and schedules
+     * all of them for trying all kinds of reductions.
+     */
+    auto restart = [&]() {
+        dfs.reset(new Dfs(region));
+
+        postordering = dfs->postordering();
+
+        node2index.clear();
+        for (std::size_t i = 0; i < postordering.size(); ++i) {
+            node2index[postordering[i]] = i;
+        }
+
+        preorderNumbers.resize(postordering.size());
+        for (std::size_t i = 0; i < dfs->preordering().size(); ++i) {
+            preorderNumbers[node2index[dfs->preordering()[i]]] = i;
+        }
+
+        loopEntries.clear();
+        for (std::size_t i = 0; i < postordering.size(); ++i) {
+            foreach (const Edge *edge, postordering[i]->inEdges()) {
+                if (dfs->getEdgeType(edge) == Dfs::BACK) {
+                    loopEntries.push_back(i);
+                    break;
+                }
             }
         }
-        if (changed) {
+
+        foreach (std::set<std::size_t> &worklist, worklists) {
+            worklist.clear();
+            for (std::size_t i = 0; i < postordering.size(); ++i) {
+                worklist.insert(worklist.end(), i);
+            }
+        }
+    };
+
+    auto reschedule = [&](const Node *node) {
+        assert(nc::contains(node2index, node));
+
+        std::size_t index = node2index[node];
+        foreach (std::set<std::size_t> &worklist, worklists) {
+            worklist.insert(index);
+        }
+    };
+
+    restart();
+
+    while (true) {
+        auto worklist = std::find_if(worklists.begin(), worklists.end(),
+            [](const std::set<std::size_t> &worklist) { return !worklist.empty(); });
+
+        if (worklist == worklists.end()) {
+            break;
+        }
+
+        Node *node = postordering[*worklist->begin()];
+        worklist->erase(worklist->begin());
+
+        /* The node has already become a part of some subregion. */
+        if (node->parent() != region) {
             continue;
         }
 
-        foreach (Node *node, dfs.postordering()) {
-            if (reduceCyclic(node, dfs)) {
-                changed = true;
+        bool reduced = false;
+
+        switch (worklist - worklists.begin()) {
+            case COMPOUND_CONDITION:
+                reduced = reduceCompoundCondition(node);
                 break;
-            }
+            case CYCLIC:
+                reduced = reduceCyclic(node, *dfs);
+                break;
+            case BLOCK:
+                reduced = reduceBlock(node);
+                break;
+            case CONDITIONAL:
+                reduced = reduceConditional(node);
+                break;
+            case SWITCH_OR_HOPELESS_CONDITIONAL:
+                reduced = reduceSwitch(node) || reduceHopelessConditional(node);
+                break;
+            default:
+                unreachable();
         }
-        if (changed) {
+
+        if (!reduced) {
             continue;
         }
 
-        foreach (Node *node, dfs.postordering()) {
-            if (reduceBlock(node)) {
-                changed = true;
-                break;
-            }
+        /*
+         * Every reduction puts the node it was tried on into the new subregion.
+         * Reducing a loop also structures the loop's body, so the node can be
+         * nested deeper.
+         */
+        Region *subregion = node->parent();
+        while (subregion->parent() != region) {
+            subregion = subregion->parent();
+            assert(subregion != NULL);
         }
-        if (changed) {
+
+        if (multiEntrySubregions_.erase(subregion)) {
+            restart();
             continue;
         }
 
-        foreach (Node *node, dfs.postordering()) {
-            if (reduceConditional(node)) {
-                changed = true;
-                break;
+        /*
+         * As the subregion is entered only via its entry, the entry is an
+         * ancestor of all the other subregion's nodes in the DFS tree.
+         * Therefore, putting the subregion in place of the entry keeps the
+         * postorder a valid topological order, and the edges to and from
+         * the subregion keep their types.
+         */
+        std::size_t index = node2index[subregion->entry()];
+        postordering[index] = subregion;
+        node2index[subregion] = index;
+
+        /*
+         * Whether a reduction is possible at a node depends only on the
+         * node's successors, their successors and predecessors, and the
+         * node's predecessors. Recheck the nodes for which this information
+         * could change.
+         */
+        reschedule(subregion);
+
+        foreach (const Edge *edge, subregion->inEdges()) {
+            Node *predecessor = edge->tail();
+            reschedule(predecessor);
+
+            foreach (const Edge *predecessorEdge, predecessor->inEdges()) {
+                reschedule(predecessorEdge->tail());
+            }
+            foreach (const Edge *predecessorEdge, predecessor->outEdges()) {
+                reschedule(predecessorEdge->head());
             }
         }
-        if (changed) {
-            continue;
+
+        foreach (const Edge *edge, subregion->outEdges()) {
+            Node *successor = edge->head();
+            reschedule(successor);
+
+            foreach (const Edge *successorEdge, successor->inEdges()) {
+                reschedule(successorEdge->tail());
+            }
         }
 
-        foreach (Node *node, dfs.postordering()) {
-            if (reduceSwitch(node) || reduceHopelessConditional(node)) {
-                changed = true;
-                break;
+        /*
+         * Whether a loop can be reduced depends on all the nodes of the loop.
+         * Recheck the entries of all the loops which can contain the subregion,
+         * i.e. whose entries are the subregion's ancestors in the DFS tree.
+         */
+        foreach (std::size_t loopEntry, loopEntries) {
+            if (loopEntry > index && preorderNumbers[loopEntry] < preorderNumbers[index]) {
+                worklists[CYCLIC].insert(loopEntry);
             }
         }
-        if (changed) {
-            continue;
+    }
+
+    multiEntrySubregions_.swap(outerMultiEntrySubregions);
+}
+
+void StructureAnalyzer::install(Region *parent, Region *subregion) {
+    assert(parent != NULL);
+    assert(subregion != NULL);
+
+    foreach (const Node *node, subregion->nodes()) {
+        if (node != subregion->entry()) {
+            foreach (const Edge *edge, node->inEdges()) {
+                if (edge->tail()->parent() != subregion) {
+                    multiEntrySubregions_.insert(subregion);
+                    break;
+                }
+            }
         }
-    } while (changed);
+    }
+
+    parent->addSubregion(subregion);
 }
 
 bool StructureAnalyzer::reduceBlock(Node *entry) {
@@ -145,7 +299,7 @@ bool StructureAnalyzer::reduceBlock(Node *entry) {
             region->addNode(node);
         }
         region->setEntry(entry);
-        parent->addSubregion(region);
+        install(parent, region);
         return true;
     }
 
@@ -175,7 +329,7 @@ bool StructureAnalyzer::reduceConditional(Node *entry) {
         region->addNode(left);
         region->addNode(right);
         region->setEntry(entry);
-        parent->addSubregion(region);
+        install(parent, region);
         return true;
     }
 
@@ -192,7 +346,7 @@ bool StructureAnalyzer::reduceConditional(Node *entry) {
         region->addNode(left);                                                      \
         region->setEntry(entry);                                                    \
         region->setExitBasicBlock(right->getEntryBasicBlock());                     \
-        parent->addSubregion(region);                                               \
+        install(parent, region);                                                    \
         return true;                                                                \
     }
     REDUCE(left, right)
@@ -217,7 +371,7 @@ bool StructureAnalyzer::reduceHopelessConditional(Node *entry) {
     region->addNode(left);
     region->addNode(right);
     region->setEntry(entry);
-    parent->addSubregion(region);
+    install(parent, region);
 
     return true;
 }
@@ -241,7 +395,7 @@ bool StructureAnalyzer::reduceCompoundCondition(Node *entry) {
         region->addNode(entry);                                                             \
         region->addNode(left);                                                              \
         region->setEntry(entry);                                                            \
-        parent->addSubregion(region);                                                       \
+        install(parent, region);                                                            \
         return true;                                                                        \
     }
     REDUCE(left, right)
@@ -317,7 +471,7 @@ bool StructureAnalyzer::reduceCyclic(Node *entry, const Dfs &dfs) {
     /*
      * Install this new region, redirect edges.
      */
-    parent->addSubregion(region);
+    install(parent, region);
 
     /*
      * Remove 'continue' edges. They only make the structural
@@ -551,7 +705,7 @@ bool StructureAnalyzer::reduceSwitch(Node *entry) {
     /*
      * Install this new region, redirect edges.
      */
-    parent->addSubregion(region);
+    install(parent, region);
 
     return true;
 }
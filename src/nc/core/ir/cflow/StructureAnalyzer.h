@@ -22,6 +22,8 @@
 
 #include <nc/config.h>
 
+#include <boost/unordered_set.hpp>
+
 namespace nc {
 namespace core {
 namespace ir {
@@ -47,6 +49,13 @@ class StructureAnalyzer {
     /** Dataflow information. */
     const dflow::Dataflow &dataflow_;
 
+    /**
+     * Subregions whose nodes, besides the entry, had edges from outside
+     * at the moment of installation. The edges are dropped by
+     * Region::addSubregion(), which invalidates the DFS of the parent.
+     */
+    boost::unordered_set<const Region *> multiEntrySubregions_;
+
     public:
 
     /**
@@ -69,10 +78,26 @@ class StructureAnalyzer {
     /**
      * Runs structural analysis in the region.
      *
+     * Reductions are tried in the order of their priority, and among
+     * the nodes allowing a reduction of the same kind, the first one in
+     * DFS postorder is chosen. After each reduction, the new subregion
+     * takes the place of its entry in the postorder, and only the nodes
+     * in its neighbourhood and the entries of the loops enclosing it are
+     * checked again. The DFS is recomputed only after reducing a subregion
+     * with multiple entries.
+     *
      * \param[in] region Valid pointer to a region.
      */
     void analyze(Region *region);
 
+    /**
+     * Installs a subregion into its parent region, redirecting the edges.
+     *
+     * \param[in] parent Valid pointer to the parent region.
+     * \param[in] subregion Valid pointer to the subregion.
+     */
+    void install(Region *parent, Region *subregion);
+
     /**
      * Tries to reduce block region ending in the node.
      *
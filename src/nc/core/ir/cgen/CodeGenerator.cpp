@@ -166,7 +166,7 @@ likec::VariableDeclaration *CodeGenerator::makeGlobalVariableDeclaration(const M
             ByteAddr addr = memoryLocation.addr() / CHAR_BIT;
             comment = context().module()->getName(addr);
             if (!comment.isEmpty()) {
-                name = likec::Tree::cleanName(context().module()->getName(addr));
+                name = likec::Tree::cleanName(comment);
                 if (name == comment) {
                     comment = QString();
                 }
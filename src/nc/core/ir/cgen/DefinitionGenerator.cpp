@@ -677,8 +677,8 @@ std::unique_ptr<likec::Statement> DefinitionGenerator::doMakeStatement(const Sta
 
             auto callOperator = std::make_unique<likec::CallOperator>(tree(), std::move(target));
 
-            if (const calls::FunctionSignature *signature = context().callsData()->getFunctionSignature(call)) {
-                if (calls::CallAnalyzer *callAnalyzer = context().callsData()->getCallAnalyzer(call)) {
+            if (const calls::FunctionSignature *signature = context().callsData()->getFunctionSignature(function(), call)) {
+                if (calls::CallAnalyzer *callAnalyzer = context().callsData()->getCallAnalyzer(function(), call)) {
                     foreach (const MemoryLocation &memoryLocation, signature->arguments()) {
                         callOperator->addArgument(makeExpression(callAnalyzer->getArgumentTerm(memoryLocation)));
                     }
@@ -1080,7 +1080,7 @@ std::unique_ptr<likec::Expression> DefinitionGenerator::makeConstant(const Term
 
 bool DefinitionGenerator::isIntermediate(const Term *term) const {
     if (term->isWrite()) {
-        const std::vector<const Term *> &reads = dataflow().getUses(term);
+        auto reads = dataflow().getUses(term);
 
         const Term *usedRead;
 
@@ -1102,7 +1102,7 @@ bool DefinitionGenerator::isIntermediate(const Term *term) const {
         return false;
     }
     if (term->isRead()) {
-        const std::vector<const Term *> &writes = dataflow().getDefinitions(term);
+        auto writes = dataflow().getDefinitions(term);
         return writes.size() == 1 && isIntermediate(writes.front());
     }
     return false;
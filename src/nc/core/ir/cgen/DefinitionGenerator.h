@@ -24,6 +24,8 @@
 
 #include <boost/unordered_map.hpp>
 
+#include <nc/core/ir/vars/Variable.h>
+
 #include "DeclarationGenerator.h"
 
 namespace nc {
@@ -57,7 +59,6 @@ namespace dflow {
 }
 
 namespace vars {
-    class Variable;
     class Variables;
 }
 
@@ -81,7 +82,7 @@ class DefinitionGenerator: public DeclarationGenerator {
     likec::FunctionDefinition *definition_; ///< Function's definition.
 
     int serial_; ///< Last serial number of local variable.
-    boost::unordered_map<const ir::vars::Variable *, likec::VariableDeclaration *> variableDeclarations_; ///< Local variables of current function definition.
+    boost::unordered_map<vars::VariableId, likec::VariableDeclaration *> variableDeclarations_; ///< Local variables of current function definition.
 
     boost::unordered_map<const BasicBlock *, likec::LabelDeclaration *> labels_; ///< Labels inside the function.
 
@@ -21,6 +21,12 @@
 
 #include "Dataflow.h"
 
+#include <algorithm>
+#include <cassert>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+
 #include <nc/core/ir/Term.h>
 
 namespace nc {
@@ -28,12 +34,63 @@ namespace core {
 namespace ir {
 namespace dflow {
 
-Value *Dataflow::getValue(const Term *term) {
-    auto &result = values_[term];
-    if (!result) {
-        result.reset(new Value(term->size()));
+void Dataflow::TermList::push_back(const Term *term) {
+    if (size_ == capacity_) {
+        const Term **terms = new const Term *[capacity_ * 2];
+        std::copy(data(), data() + size_, terms);
+
+        if (capacity_ != INLINE_SIZE) {
+            delete[] heap_;
+        }
+        heap_ = terms;
+        capacity_ *= 2;
     }
-    return result.get();
+    data()[size_++] = term;
+}
+
+void Dataflow::TermList::remove(const Term *term) {
+    const Term **begin = data();
+    const Term **i = std::find(begin, begin + size_, term);
+    assert(i != begin + size_);
+
+    std::copy(i + 1, begin + size_, i);
+    --size_;
+}
+
+void Dataflow::TermList::assign(const std::vector<const Term *> &terms) {
+    clear();
+    foreach (const Term *term, terms) {
+        push_back(term);
+    }
+}
+
+Dataflow::TermInfo::TermInfo(const Term *term):
+    term(term), value(term->size())
+{}
+
+Dataflow::TermInfo &Dataflow::getInfo(const Term *term) {
+    assert(term != NULL);
+
+    auto result = index_.insert(term);
+    if (result.second) {
+        infos_.emplace_back(term);
+    }
+    return infos_[result.first];
+}
+
+const Dataflow::TermInfo *Dataflow::findInfo(const Term *term) const {
+    assert(term != NULL);
+
+    std::size_t number = index_.find(term);
+    if (number != TermIndex::NOT_FOUND) {
+        return &infos_[number];
+    } else {
+        return NULL;
+    }
+}
+
+Value *Dataflow::getValue(const Term *term) {
+    return &getInfo(term).value;
 }
 
 const Value *Dataflow::getValue(const Term *term) const {
@@ -41,9 +98,8 @@ const Value *Dataflow::getValue(const Term *term) const {
 }
 
 const ir::MemoryLocation &Dataflow::getMemoryLocation(const Term *term) const {
-    auto i = memoryLocations_.find(term);
-    if (i != memoryLocations_.end()) {
-        return i->second;
+    if (const TermInfo *info = findInfo(term)) {
+        return info->memoryLocation;
     } else {
         static const MemoryLocation empty;
         return empty;
@@ -54,19 +110,23 @@ void Dataflow::setMemoryLocation(const Term *term, const MemoryLocation &memoryL
     if (!memoryLocation) {
         unsetMemoryLocation(term);
     } else {
-        memoryLocations_[term] = memoryLocation;
+        getInfo(term).memoryLocation = memoryLocation;
+    }
+}
+
+void Dataflow::unsetMemoryLocation(const Term *term) {
+    if (findInfo(term)) {
+        getInfo(term).memoryLocation = MemoryLocation();
     }
 }
 
-const std::vector<const Term *> &Dataflow::getDefinitions(const Term *term) const {
+Dataflow::TermRange Dataflow::getDefinitions(const Term *term) const {
     assert(term->isRead());
 
-    auto i = definitions_.find(term);
-    if (i != definitions_.end()) {
-        return *i->second;
+    if (const TermInfo *info = findInfo(term)) {
+        return info->definitions.terms();
     } else {
-        static const std::vector<const Term *> empty;
-        return empty;
+        return TermRange();
     }
 }
 
@@ -75,41 +135,75 @@ void Dataflow::setDefinitions(const Term *term, const std::vector<const Term *>
 
     if (definitions.empty()) {
         clearDefinitions(term);
-    } else {
-        auto &pointer = definitions_[term];
-        if (pointer) {
-            *pointer = definitions;
-        } else {
-            pointer.reset(new std::vector<const Term *>(definitions));
+        return;
+    }
+
+    TermList &oldDefinitions = getInfo(term).definitions;
+    TermRange oldRange = oldDefinitions.terms();
+    if (definitions.size() == static_cast<std::size_t>(oldRange.size()) &&
+        std::equal(definitions.begin(), definitions.end(), oldRange.begin())) {
+        return;
+    }
+
+    /* Update only the uses of the definitions that came or went. */
+    foreach (const Term *definition, oldRange) {
+        if (!nc::contains(definitions, definition)) {
+            removeUse(definition, term);
+        }
+    }
+    foreach (const Term *definition, definitions) {
+        if (!nc::contains(oldRange, definition)) {
+            addUse(definition, term);
         }
     }
+
+    /* The reference stays valid: infos_ is a deque, and getInfo() only appends to it. */
+    oldDefinitions.assign(definitions);
 }
 
 void Dataflow::clearDefinitions(const Term *term) {
     assert(term->isRead());
 
-    definitions_.erase(term);
+    if (findInfo(term)) {
+        TermList &definitions = getInfo(term).definitions;
+        foreach (const Term *definition, definitions.terms()) {
+            removeUse(definition, term);
+        }
+        definitions.clear();
+    }
 }
 
-const std::vector<const Term *> &Dataflow::getUses(const Term *term) const {
-    auto i = uses_.find(term);
-    if (i != uses_.end()) {
-        return *i->second;
-    } else {
-        static const std::vector<const Term *> empty;
-        return empty;
+void Dataflow::retainDefinitions(const std::vector<const Term *> &terms) {
+    TermIndex retained;
+    foreach (const Term *term, terms) {
+        retained.insert(term);
+    }
+
+    for (std::size_t i = 0; i < infos_.size(); ++i) {
+        if (!infos_[i].definitions.empty() && retained.find(infos_[i].term) == TermIndex::NOT_FOUND) {
+            clearDefinitions(infos_[i].term);
+        }
     }
 }
 
-void Dataflow::addUse(const Term *term, const Term *use) {
-    auto &pointer = uses_[term];
-    if (!pointer) {
-        pointer.reset(new std::vector<const Term *>(1, use));
+Dataflow::TermRange Dataflow::getUses(const Term *term) const {
+    if (const TermInfo *info = findInfo(term)) {
+        return info->uses.terms();
     } else {
-        pointer->push_back(use);
+        return TermRange();
     }
 }
 
+void Dataflow::addUse(const Term *term, const Term *use) {
+    getInfo(term).uses.push_back(use);
+}
+
+void Dataflow::removeUse(const Term *term, const Term *use) {
+    assert(findInfo(term) != NULL);
+
+    getInfo(term).uses.remove(use);
+}
+
 } // namespace dflow
 } // namespace ir
 } // namespace core
@@ -22,12 +22,14 @@
 
 #include <nc/config.h>
 
+#include <deque>
 #include <vector>
-#include <memory> /* unique_ptr */
 
-#include <boost/unordered_map.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <nc/core/ir/MemoryLocation.h>
+#include <nc/core/ir/TermIndex.h>
 
 #include "Value.h"
 
@@ -41,12 +43,105 @@ namespace dflow {
 
 /**
  * This class contains results of dataflow and constant propagation and folding analysis.
+ *
+ * Information about a term is kept in an array indexed by the term's number
+ * in a TermIndex, which is found by the term's identifier without hashing.
+ * Definitions and uses of a term are kept inline while there are few of them.
  */
 class Dataflow {
-    boost::unordered_map<const Term *, std::unique_ptr<Value> > values_; ///< Term values.
-    boost::unordered_map<const Term *, MemoryLocation> memoryLocations_; ///< Term memory locations.
-    boost::unordered_map<const Term *, std::unique_ptr<std::vector<const Term *> > > definitions_; ///< Term definitions.
-    boost::unordered_map<const Term *, std::unique_ptr<std::vector<const Term *> > > uses_; ///< Term uses.
+    public:
+
+    /** Range of terms. */
+    typedef boost::iterator_range<const Term *const *> TermRange;
+
+    private:
+
+    /**
+     * List of terms. Up to INLINE_SIZE terms are kept inline, more in a heap array.
+     */
+    class TermList: boost::noncopyable {
+        /** Number of terms kept without a heap allocation. */
+        static const unsigned INLINE_SIZE = 2;
+
+        unsigned size_; ///< Number of terms.
+        unsigned capacity_; ///< Number of terms the storage can hold.
+
+        union {
+            const Term *inline_[INLINE_SIZE]; ///< Inline storage, used if capacity_ == INLINE_SIZE.
+            const Term **heap_; ///< Heap array, used otherwise.
+        };
+
+        const Term **data() { return capacity_ == INLINE_SIZE ? inline_ : heap_; }
+        const Term *const *data() const { return capacity_ == INLINE_SIZE ? inline_ : heap_; }
+
+        public:
+
+        TermList(): size_(0), capacity_(INLINE_SIZE) {}
+
+        ~TermList() {
+            if (capacity_ != INLINE_SIZE) {
+                delete[] heap_;
+            }
+        }
+
+        /**
+         * \return The terms.
+         */
+        TermRange terms() const { return TermRange(data(), data() + size_); }
+
+        /**
+         * \return True iff the list is empty.
+         */
+        bool empty() const { return size_ == 0; }
+
+        /**
+         * Appends a term to the list.
+         *
+         * \param[in] term Valid pointer to the term.
+         */
+        void push_back(const Term *term);
+
+        /**
+         * Removes a term from the list.
+         *
+         * \param[in] term Valid pointer to a term in the list.
+         */
+        void remove(const Term *term);
+
+        /**
+         * Replaces the contents of the list.
+         *
+         * \param[in] terms New contents of the list.
+         */
+        void assign(const std::vector<const Term *> &terms);
+
+        /**
+         * Removes all the terms from the list.
+         */
+        void clear() { size_ = 0; }
+    };
+
+    /**
+     * Everything known about a single term.
+     */
+    struct TermInfo: boost::noncopyable {
+        const Term *term; ///< The term.
+        Value value; ///< Term value.
+        MemoryLocation memoryLocation; ///< Term memory location.
+        TermList definitions; ///< Term definitions.
+        TermList uses; ///< Term uses.
+
+        explicit TermInfo(const Term *term);
+    };
+
+    /** Numbers of the terms, indices in infos_. */
+    TermIndex index_;
+
+    /**
+     * Information about the terms, indexed by their numbers.
+     * A deque, because pointers to values must survive insertions.
+     */
+    std::deque<TermInfo> infos_;
 
     public:
 
@@ -86,15 +181,15 @@ class Dataflow {
      *
      * \param[in] term Term.
      */
-    void unsetMemoryLocation(const Term *term) { memoryLocations_.erase(term); }
+    void unsetMemoryLocation(const Term *term);
 
     /**
      * \param[in] term Valid pointer to a "read" term.
      *
      * \return List of term's definitions. If it has not been set before,
-     *         an empty vector is returned.
+     *         an empty range is returned.
      */
-    const std::vector<const Term *> &getDefinitions(const Term *term) const;
+    TermRange getDefinitions(const Term *term) const;
 
     /**
      * Sets the list of term's definitions.
@@ -111,13 +206,25 @@ class Dataflow {
      */
     void clearDefinitions(const Term *term);
 
+    /**
+     * Clears the definitions of all the terms except the given ones.
+     *
+     * \param[in] terms Terms whose definitions must be kept.
+     */
+    void retainDefinitions(const std::vector<const Term *> &terms);
+
     /**
      * \param[in] term Term.
      *
      * \return List of term's uses. If it has not been set before,
-     *         an empty vector is returned.
+     *         an empty range is returned.
+     *
+     * Uses are kept consistent with definitions: a term is a use of
+     * each of its definitions.
      */
-    const std::vector<const Term *> &getUses(const Term *term) const;
+    TermRange getUses(const Term *term) const;
+
+    private:
 
     /**
      * Adds a use of a term.
@@ -128,11 +235,26 @@ class Dataflow {
     void addUse(const Term *term, const Term *use);
 
     /**
-     * Clears the set of term's definitions.
+     * Removes a use of a term.
      *
-     * \param[in] term Term.
+     * \param[in] term "Write" term being used.
+     * \param[in] use  "Read" term using the "write" term.
+     */
+    void removeUse(const Term *term, const Term *use);
+
+    /**
+     * \param[in] term Valid pointer to a term.
+     *
+     * \return Pointer to the information about the term, or NULL if there is none.
+     */
+    const TermInfo *findInfo(const Term *term) const;
+
+    /**
+     * \param[in] term Valid pointer to a term.
+     *
+     * \return Information about the term, created if necessary.
      */
-    void clearUses(const Term *term) { uses_.erase(term); }
+    TermInfo &getInfo(const Term *term);
 };
 
 } // namespace dflow
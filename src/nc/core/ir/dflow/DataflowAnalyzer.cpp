@@ -21,10 +21,15 @@
 
 #include "DataflowAnalyzer.h"
 
-#include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <set>
 
 #include <nc/common/CancellationToken.h>
 #include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+#include <nc/common/Visitor.h>
 #include <nc/common/Warnings.h>
 
 #include <nc/core/arch/Architecture.h>
@@ -32,6 +37,7 @@
 #include <nc/core/arch/Register.h>
 #include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/CFG.h>
+#include <nc/core/ir/DominatorTree.h>
 #include <nc/core/ir/Function.h>
 #include <nc/core/ir/Jump.h>
 #include <nc/core/ir/Statements.h>
@@ -44,96 +50,524 @@
 
 #include "Dataflow.h"
 #include "SimulationContext.h"
+#include "SsaForm.h"
+#include "Value.h"
 
 namespace nc {
 namespace core {
 namespace ir {
 namespace dflow {
 
+namespace {
+
+/**
+ * Appends the accesses of a term and its children to the memory locations
+ * tracked by dataflow analysis, in the order DataflowAnalyzer simulates them.
+ *
+ * \param analyzer Dataflow analyzer.
+ * \param term Valid pointer to a term.
+ * \param accesses Output vector of accesses.
+ */
+void collectAccesses(const DataflowAnalyzer &analyzer, const Term *term, std::vector<SsaForm::Access> &accesses) {
+    assert(term != NULL);
+
+    auto visitor = makeVisitor<const Term>([&](const Term *child) {
+        collectAccesses(analyzer, child, accesses);
+    });
+    term->visitChildTerms(visitor);
+
+    const MemoryLocation &memoryLocation = term->isMemoryLocationAccess() ?
+        term->asMemoryLocationAccess()->memoryLocation() : analyzer.dataflow().getMemoryLocation(term);
+
+    if (memoryLocation && !analyzer.architecture()->isGlobalMemory(memoryLocation)) {
+        accesses.push_back(SsaForm::Access(term, memoryLocation));
+    }
+}
+
+/**
+ * Appends the accesses of a statement to the memory locations tracked
+ * by dataflow analysis, in the order DataflowAnalyzer simulates them.
+ *
+ * \param analyzer Dataflow analyzer.
+ * \param statement Valid pointer to a statement.
+ * \param accesses Output vector of accesses.
+ */
+void collectAccesses(const DataflowAnalyzer &analyzer, const Statement *statement, std::vector<SsaForm::Access> &accesses) {
+    assert(statement != NULL);
+
+    switch (statement->kind()) {
+        case Statement::ASSIGNMENT:
+            collectAccesses(analyzer, statement->asAssignment()->right(), accesses);
+            collectAccesses(analyzer, statement->asAssignment()->left(), accesses);
+            break;
+        case Statement::KILL:
+            collectAccesses(analyzer, statement->asKill()->term(), accesses);
+            break;
+        case Statement::JUMP: {
+            const Jump *jump = statement->asJump();
+            if (jump->condition()) {
+                collectAccesses(analyzer, jump->condition(), accesses);
+            }
+            if (jump->thenTarget().address()) {
+                collectAccesses(analyzer, jump->thenTarget().address(), accesses);
+            }
+            if (jump->elseTarget().address()) {
+                collectAccesses(analyzer, jump->elseTarget().address(), accesses);
+            }
+            break;
+        }
+        case Statement::CALL:
+            collectAccesses(analyzer, statement->asCall()->target(), accesses);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Computes the changes turning one set of reaching definitions into another.
+ *
+ * \param before Definitions before, sorted by memory location.
+ * \param after Definitions after, sorted by memory location.
+ *
+ * \return The changes.
+ */
+std::vector<SsaForm::Change> getChanges(const std::vector<ReachingDefinition> &before, const std::vector<ReachingDefinition> &after) {
+    std::vector<SsaForm::Change> result;
+
+    auto i = before.begin();
+    auto j = after.begin();
+
+    while (i != before.end() || j != after.end()) {
+        if (j == after.end() || (i != before.end() && i->first < j->first)) {
+            result.push_back(SsaForm::Change(i->first, false, std::vector<const Term *>()));
+            ++i;
+        } else if (i == before.end() || j->first < i->first) {
+            result.push_back(SsaForm::Change(j->first, true, j->second));
+            ++j;
+        } else {
+            if (i->second != j->second) {
+                if (std::includes(j->second.begin(), j->second.end(), i->second.begin(), i->second.end())) {
+                    std::vector<const Term *> added;
+                    std::set_difference(j->second.begin(), j->second.end(), i->second.begin(), i->second.end(), std::back_inserter(added));
+                    result.push_back(SsaForm::Change(j->first, true, added));
+                } else {
+                    result.push_back(SsaForm::Change(j->first, false, j->second));
+                }
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Merges the changes made by an opaque unit in its last simulation into the
+ * ones made in the previous simulations. A merged change keeps the old
+ * definitions only if all the changes of the location did, and adds all the
+ * terms they added. This way the changes only grow, and the SSA form built
+ * from them stabilizes, even though the changes made by the unit depend on
+ * the definitions reaching it, which depend on the changes.
+ *
+ * \param changes Changes made in the previous simulations, sorted by memory location.
+ * \param newChanges Changes made in the last simulation, sorted by memory location.
+ */
+void mergeChanges(std::vector<SsaForm::Change> &changes, const std::vector<SsaForm::Change> &newChanges) {
+    std::vector<SsaForm::Change> result;
+    result.reserve(changes.size() + newChanges.size());
+
+    auto i = changes.begin();
+    auto j = newChanges.begin();
+
+    while (i != changes.end() || j != newChanges.end()) {
+        if (j == newChanges.end() || (i != changes.end() && i->memoryLocation < j->memoryLocation)) {
+            result.push_back(*i++);
+        } else if (i == changes.end() || j->memoryLocation < i->memoryLocation) {
+            result.push_back(*j++);
+        } else {
+            std::vector<const Term *> terms;
+            std::set_union(i->terms.begin(), i->terms.end(), j->terms.begin(), j->terms.end(), std::back_inserter(terms));
+            result.push_back(SsaForm::Change(i->memoryLocation, i->keep && j->keep, terms));
+            ++i;
+            ++j;
+        }
+    }
+
+    changes.swap(result);
+}
+
+} // anonymous namespace
+
 void DataflowAnalyzer::analyze(const Function *function, const CancellationToken &canceled) {
-    CFG cfg(function->basicBlocks());
+    analyze(function, CFG(function->basicBlocks()), canceled);
+}
+
+void DataflowAnalyzer::analyze(const Function *function, const CFG &cfg, const CancellationToken &canceled) {
+    /*
+     * Basic blocks are simulated in reverse postorder,
+     * so that a block usually goes after its predecessors.
+     */
+    std::vector<const BasicBlock *> order = cfg.getReversePostorder(function->entry());
+
+    /* Mapping from a number in reverse postorder to the index in the CFG. */
+    std::vector<std::size_t> order2index(order.size());
+
+    /* Mapping from an index in the CFG to the number in reverse postorder. */
+    std::vector<std::size_t> index2order(cfg.size());
+
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order2index[i] = cfg.getIndex(order[i]);
+        index2order[order2index[i]] = i;
+    }
+
+    /* Numbering of register definitions, shared by all the reaching definitions below. */
+    DefinitionNumbering numbering;
+
+    /* Reaching definitions at the ends of basic blocks, by CFG index. */
+    std::vector<ReachingDefinitions> outputDefinitions(cfg.size(), ReachingDefinitions(&numbering));
+
+    /* Numbers (in reverse postorder) of basic blocks waiting for simulation. */
+    std::set<std::size_t> worklist;
+
+    /*
+     * Simulation of loops converges much faster than in the number of
+     * basic blocks, so this limit is only a safety net against oscillation.
+     */
+    const std::size_t maxSimulations = order.size() * 100;
+    std::size_t nsimulations = 0;
+
+    /*
+     * Simulates the basic block with the given number in reverse postorder
+     * and schedules its successors for simulation, if the outgoing reaching
+     * definitions changed.
+     */
+    auto simulateBasicBlock = [&](std::size_t number, bool fixpointReached) {
+        const BasicBlock *basicBlock = order[number];
+        const std::size_t index = order2index[number];
+
+        SimulationContext context(*this, function, fixpointReached, &numbering);
+
+        /* Merge the reaching definitions from predecessors. */
+        foreach (std::size_t predecessor, cfg.getPredecessorIndices(index)) {
+            context.definitions().join(outputDefinitions[predecessor]);
+        }
+
+        /* If this is a function entry, run the calling convention-specific code. */
+        if (basicBlock == function->entry()) {
+            if (callsData()) {
+                if (calls::FunctionAnalyzer *functionAnalyzer = callsData()->getFunctionAnalyzer(function)) {
+                    functionAnalyzer->simulateEnter(context);
+                }
+            }
+        }
+
+        /* Simulate all the statements in the basic block. */
+        foreach (const Statement *statement, basicBlock->statements()) {
+            simulate(statement, context);
+        }
+
+        ++nsimulations;
+
+        /* Something changed? */
+        ReachingDefinitions &definitions(outputDefinitions[index]);
+        if (definitions != context.definitions()) {
+            definitions = context.definitions();
+
+            foreach (std::size_t successor, cfg.getSuccessorIndices(index)) {
+                worklist.insert(index2order[successor]);
+            }
+        }
+    };
+
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        worklist.insert(worklist.end(), i);
+    }
 
     /*
-     * Run simulation until reaching stationary point twice in a row.
+     * Run the worklist until the reaching definitions stabilize,
+     * then simulate all the basic blocks once more, telling the
+     * analyzers that the fixpoint is reached. Repeat, if this
+     * final pass has changed anything.
      */
-    boost::unordered_map<const BasicBlock *, ReachingDefinitions> outputDefinitions;
+    while (!worklist.empty() && !canceled) {
+        while (!worklist.empty() && !canceled) {
+            if (nsimulations >= maxSimulations) {
+                ncWarning("Didn't reach a fixpoint after %1 simulations of basic blocks while analyzing dataflow of %2. Giving up.", nsimulations, function->name());
+                worklist.clear();
+                break;
+            }
+
+            std::size_t number = *worklist.begin();
+            worklist.erase(worklist.begin());
+
+            simulateBasicBlock(number, false);
+        }
+
+        if (worklist.empty() && !canceled && nsimulations < maxSimulations) {
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                simulateBasicBlock(i, true);
+            }
+        }
+    }
 
-    int niterations = 0;
-    bool changed;
-    bool fixpointReached = false;
+    /*
+     * Uses are maintained by Dataflow::setDefinitions() as we go.
+     * It only remains to forget the definitions of terms that are
+     * no longer part of the function, e.g. terms of a call analyzer
+     * that has been replaced after the call target became known.
+     */
+    misc::CensusVisitor census(callsData());
+    census(function);
+    dataflow().retainDefinitions(census.terms());
+}
 
-    do {
-        changed = false;
+void DataflowAnalyzer::analyzeSparsely(const Function *function, const CFG &cfg, const DominatorTree &dominatorTree, const CancellationToken &canceled) {
+    /*
+     * Units of simulation are the statements of basic blocks in reverse
+     * postorder, preceded by the calling convention-specific code run on
+     * entry to the function. The latter, calls, and returns are opaque to
+     * the SSA form when calls data is present.
+     */
+    /* Statements of units, NULL for the entry, and their steps. */
+    std::vector<const Statement *> statements;
+    std::vector<SsaForm::Step> steps;
+
+    foreach (const BasicBlock *basicBlock, cfg.getReversePostorder(function->entry())) {
+        if (basicBlock == function->entry() && callsData()) {
+            statements.push_back(NULL);
+            steps.push_back(SsaForm::Step(basicBlock, true));
+        }
+        foreach (const Statement *statement, basicBlock->statements()) {
+            statements.push_back(statement);
+            steps.push_back(SsaForm::Step(basicBlock, callsData() &&
+                (statement->kind() == Statement::CALL || statement->kind() == Statement::RETURN)));
+        }
+    }
 
-        /*
-         * Compute definitions.
-         */
-        foreach (const BasicBlock *basicBlock, function->basicBlocks()) {
-            SimulationContext context(*this, function, fixpointReached);
+    /* Changes of reaching definitions made by opaque units, merged over all their simulations. */
+    std::vector<std::vector<SsaForm::Change> > changes(statements.size());
 
-            /* Merge the reaching definitions from predecessors. */
-            foreach (const BasicBlock *predecessor, cfg.getPredecessors(basicBlock)) {
-                context.definitions().join(outputDefinitions[predecessor]);
+    /*
+     * Computes the steps of the units: accesses of plain ones to the
+     * locations known from the current dataflow information, and
+     * the changes made by opaque ones.
+     */
+    auto collectSteps = [&]() -> std::vector<SsaForm::Step> {
+        std::vector<SsaForm::Step> result;
+        result.reserve(steps.size());
+
+        for (std::size_t unit = 0; unit < steps.size(); ++unit) {
+            result.push_back(SsaForm::Step(steps[unit].basicBlock, steps[unit].isOpaque));
+            if (steps[unit].isOpaque) {
+                result.back().changes = changes[unit];
+            } else {
+                collectAccesses(*this, statements[unit], result.back().accesses);
             }
+        }
+        return result;
+    };
+
+    /* Mapping from a term to the unit it belongs to. */
+    TermIndex termIndex;
+    std::vector<std::size_t> term2unit;
+
+    /* Terms written by each unit. */
+    std::vector<std::vector<const Term *> > writes(statements.size());
+
+    /*
+     * Records the terms of the unit, including the ones of the analyzers,
+     * which can create terms during the simulation.
+     */
+    auto registerTerms = [&](std::size_t unit) {
+        misc::CensusVisitor census(NULL);
+
+        if (const Statement *statement = statements[unit]) {
+            census(statement);
 
-            /* If this is a function entry, run the calling convention-specific code. */
-            if (basicBlock == function->entry()) {
-                if (callsData()) {
-                    if (calls::FunctionAnalyzer *functionAnalyzer = callsData()->getFunctionAnalyzer(function)) {
-                        functionAnalyzer->simulateEnter(context);
+            if (steps[unit].isOpaque) {
+                if (statement->kind() == Statement::CALL) {
+                    if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(function, statement->asCall())) {
+                        callAnalyzer->visitChildStatements(census);
+                        callAnalyzer->visitChildTerms(census);
+                    }
+                } else {
+                    if (calls::ReturnAnalyzer *returnAnalyzer = callsData()->getReturnAnalyzer(function, statement->asReturn())) {
+                        returnAnalyzer->visitChildStatements(census);
+                        returnAnalyzer->visitChildTerms(census);
                     }
                 }
             }
+        } else if (calls::FunctionAnalyzer *functionAnalyzer = callsData()->getFunctionAnalyzer(function)) {
+            functionAnalyzer->visitChildStatements(census);
+            functionAnalyzer->visitChildTerms(census);
+        }
+
+        writes[unit].clear();
+        foreach (const Term *term, census.terms()) {
+            auto inserted = termIndex.insert(term);
+            if (inserted.second) {
+                term2unit.push_back(unit);
+            } else {
+                term2unit[inserted.first] = unit;
+            }
+            if (term->isWrite()) {
+                writes[unit].push_back(term);
+            }
+        }
+    };
+
+    /* Numbering of register definitions, shared by the reaching definitions of opaque units. */
+    DefinitionNumbering numbering;
+
+    /* SSA form built in the current round. */
+    std::unique_ptr<SsaForm> ssaForm;
+
+    /* Numbers of units waiting for simulation. */
+    std::set<std::size_t> worklist;
+
+    /* Numbers of changes of the values of written terms, indexed by term numbers. */
+    std::vector<std::size_t> nchanges;
+
+    /*
+     * The stack offset of a value can grow without a bound in a loop
+     * adjusting the stack pointer, as the bigger offset wins on a join.
+     * Once a term's value has changed too many times, it is considered
+     * not a stack offset.
+     */
+    const std::size_t maxChanges = 16;
+
+    /* A safety net against oscillation, as in analyze(). */
+    const std::size_t maxSimulations = statements.size() * 100;
+    std::size_t nsimulations = 0;
+
+    /*
+     * Simulates the unit with the given number and schedules the units
+     * using its definitions for simulation, if their values changed.
+     */
+    auto simulateUnit = [&](std::size_t unit, bool fixpointReached) {
+        std::vector<std::pair<const Term *, Value> > values;
+        values.reserve(writes[unit].size());
+        foreach (const Term *term, writes[unit]) {
+            values.push_back(std::make_pair(term, *dataflow().getValue(term)));
+        }
+
+        SimulationContext context(*this, function, fixpointReached, &numbering);
+
+        if (!steps[unit].isOpaque) {
+            context.setSsaForm(ssaForm.get());
+            simulate(statements[unit], context);
+        } else {
+            ssaForm->getReachingDefinitions(unit, context.definitions());
+            std::vector<ReachingDefinition> before = context.definitions().getAllDefinitions();
+
+            if (statements[unit]) {
+                simulate(statements[unit], context);
+            } else if (calls::FunctionAnalyzer *functionAnalyzer = callsData()->getFunctionAnalyzer(function)) {
+                functionAnalyzer->simulateEnter(context);
+            }
 
-            /* Simulate all the statements in the basic block. */
-            foreach (const Statement *statement, basicBlock->statements()) {
-                simulate(statement, context);
+            mergeChanges(changes[unit], getChanges(before, context.definitions().getAllDefinitions()));
+            registerTerms(unit);
+        }
+
+        ++nsimulations;
+
+        for (std::size_t i = 0; i < writes[unit].size(); ++i) {
+            const Term *term = writes[unit][i];
+
+            if (i < values.size() && values[i].first == term && values[i].second == *dataflow().getValue(term)) {
+                continue;
+            }
+
+            std::size_t termNumber = termIndex.find(term);
+            assert(termNumber != TermIndex::NOT_FOUND);
+            if (termNumber >= nchanges.size()) {
+                nchanges.resize(termNumber + 1);
+            }
+            if (++nchanges[termNumber] > maxChanges) {
+                dataflow().getValue(term)->makeNotStackOffset();
             }
 
-            /* Something changed? */
-            ReachingDefinitions &definitions(outputDefinitions[basicBlock]);
-            if (definitions != context.definitions()) {
-                definitions = context.definitions();
-                changed = true;
+            foreach (const Term *use, dataflow().getUses(term)) {
+                std::size_t number = termIndex.find(use);
+                if (number != TermIndex::NOT_FOUND) {
+                    worklist.insert(term2unit[number]);
+                }
             }
         }
+    };
+
+    /*
+     * The locations of stack accesses and the effects of opaque units are
+     * only known after a simulation, so the SSA form is rebuilt and the
+     * function simulated again until the SSA form stops changing. This
+     * usually takes two or three rounds. Values are kept between the
+     * rounds, as they are between the simulations in analyze(): they
+     * only go down, so a stack access, once lost, is not found again,
+     * and the rounds do not oscillate.
+     */
+    const std::size_t maxRounds = 16;
 
-        /*
-         * Compute uses.
-         */
-        misc::CensusVisitor census(callsData());
-        census(function);
+    steps = collectSteps();
 
-        foreach (const Term *term, census.terms()) {
-            dataflow().clearUses(term);
+    for (std::size_t round = 1; !canceled; ++round) {
+        ssaForm.reset(new SsaForm(cfg, dominatorTree, function->entry(), steps));
+
+        for (std::size_t unit = 0; unit < statements.size(); ++unit) {
+            registerTerms(unit);
+            worklist.insert(worklist.end(), unit);
         }
+        nsimulations = 0;
+
+        while (!worklist.empty() && !canceled) {
+            while (!worklist.empty() && !canceled) {
+                if (nsimulations >= maxSimulations) {
+                    ncWarning("Didn't reach a fixpoint after %1 simulations of statements while analyzing dataflow of %2. Giving up.", nsimulations, function->name());
+                    worklist.clear();
+                    break;
+                }
 
-        foreach (const Term *term, census.terms()) {
-            if (term->isRead()) {
-                foreach (const Term *definition, dataflow().getDefinitions(term)) {
-                    dataflow().addUse(definition, term);
+                std::size_t unit = *worklist.begin();
+                worklist.erase(worklist.begin());
+
+                simulateUnit(unit, false);
+            }
+
+            if (worklist.empty() && !canceled && nsimulations < maxSimulations) {
+                /*
+                 * Analyzers draw conclusions at the fixpoint, e.g. about
+                 * the arguments of the function, that cannot be taken back.
+                 * Draw them only from the final SSA form.
+                 */
+                if (round < maxRounds && collectSteps() != steps) {
+                    break;
+                }
+                for (std::size_t unit = 0; unit < statements.size(); ++unit) {
+                    simulateUnit(unit, true);
                 }
             }
         }
 
-        /*
-         * Have we reached a fixpoint?
-         */
-        if (changed) {
-            fixpointReached = false;
-        } else if (!fixpointReached) {
-            fixpointReached = true;
-            changed = true;
+        if (canceled) {
+            break;
         }
 
-        /*
-         * Do we loop infinitely?
-         */
-        if (++niterations >= 30) {
-            ncWarning("Didn't reach a fixpoint after %1 iterations while analyzing dataflow of %2. Giving up.", niterations, function->name());
+        std::vector<SsaForm::Step> newSteps = collectSteps();
+        if (newSteps == steps) {
+            break;
+        }
+        if (round >= maxRounds) {
+            ncWarning("SSA form didn't stabilize after %1 rounds while analyzing dataflow of %2. Giving up.", round, function->name());
             break;
         }
-    } while (changed && !canceled);
+        steps.swap(newSteps);
+    }
+
+    misc::CensusVisitor census(callsData());
+    census(function);
+    dataflow().retainDefinitions(census.terms());
 }
 
 void DataflowAnalyzer::simulate(const Statement *statement, SimulationContext &context) {
@@ -184,9 +618,15 @@ void DataflowAnalyzer::simulate(const Statement *statement, SimulationContext &c
             if (callsData()) {
                 const Value *targetValue = dataflow().getValue(call->target());
                 if (targetValue->isConstant()) {
-                    callsData()->setCalledAddress(call, targetValue->constantValue().value());
+                    callsData()->setCalledAddress(context.function(), call, targetValue->constantValue().value());
+                } else if (call->target()->asDereference()) {
+                    /* Call through a known slot, e.g. an import address table entry. */
+                    const MemoryLocation &slotLocation = dataflow().getMemoryLocation(call->target());
+                    if (slotLocation && slotLocation.domain() == MemoryDomain::MEMORY) {
+                        callsData()->setSlotAddress(context.function(), call, slotLocation.addr() / CHAR_BIT);
+                    }
                 }
-                if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(call)) {
+                if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(context.function(), call)) {
                     callAnalyzer->simulateCall(context);
                 }
             }
@@ -289,7 +729,7 @@ void DataflowAnalyzer::simulate(const Term *term, SimulationContext &context) {
     if (const MemoryLocation &memoryLocation = dataflow().getMemoryLocation(term)) {
         if (!architecture()->isGlobalMemory(memoryLocation)) {
             if (term->isRead()) {
-                const auto &definitions = context.definitions().getDefinitions(memoryLocation);
+                const auto &definitions = context.getDefinitions(term, memoryLocation);
                 dataflow().setDefinitions(term, definitions);
 
                 Value *value = dataflow().getValue(term);
@@ -297,11 +737,13 @@ void DataflowAnalyzer::simulate(const Term *term, SimulationContext &context) {
                     value->join(*dataflow().getValue(definition));
                 }
             }
-            if (term->isWrite()) {
-                context.definitions().addDefinition(memoryLocation, term);
-            }
-            if (term->isKill()) {
-                context.definitions().killDefinitions(memoryLocation);
+            if (!context.ssaForm()) {
+                if (term->isWrite()) {
+                    context.definitions().addDefinition(memoryLocation, term);
+                }
+                if (term->isKill()) {
+                    context.definitions().killDefinitions(memoryLocation);
+                }
             }
         } else {
             if (term->isRead()) {
@@ -37,6 +37,8 @@ namespace arch {
 namespace ir {
 
 class BasicBlock;
+class CFG;
+class DominatorTree;
 class Function;
 class Statement;
 class Term;
@@ -108,6 +110,32 @@ class DataflowAnalyzer {
      */
     void analyze(const Function *function, const CancellationToken &canceled);
 
+    /**
+     * Performs joint dataflow and constant propagation/folding analysis on a function.
+     *
+     * \param[in] function Function to analyze.
+     * \param[in] cfg Control flow graph of the function.
+     * \param[in] canceled Cancellation token.
+     */
+    void analyze(const Function *function, const CFG &cfg, const CancellationToken &canceled);
+
+    /**
+     * Performs the same analysis as analyze(), but sparsely: the reads
+     * of registers and stack locations get their definitions from the SSA
+     * form of the function, and a statement is simulated again only when
+     * the value of a definition it uses changes. The entry, calls, and
+     * returns simulated by the analyzers of calls data are simulated on the
+     * reaching definitions rebuilt from the SSA form; the changes they make
+     * to these, as well as the stack locations found, are taken into
+     * account in the next round, until the SSA form stops changing.
+     *
+     * \param[in] function Function to analyze.
+     * \param[in] cfg Control flow graph of the function.
+     * \param[in] dominatorTree Dominator tree of the control flow graph.
+     * \param[in] canceled Cancellation token.
+     */
+    void analyzeSparsely(const Function *function, const CFG &cfg, const DominatorTree &dominatorTree, const CancellationToken &canceled);
+
     /**
      * Simulates execution of a statement.
      *
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator> /* std::back_inserter */
 
 #include <QTextStream>
 
@@ -60,84 +61,341 @@ class Overlap: public std::unary_function<const ReachingDefinition &, bool> {
 };
 
 /**
- * Predicate returning true iff the memory location of a definition
- * is within the domain passed to the constructor.
+ * Comparator establishing a total order on ReachingDefinition objects.
  */
-class WithinDomain: public std::unary_function<const ReachingDefinition &, bool> {
-    Domain domain_;
-
+class Before {
     public:
 
-    WithinDomain(Domain domain): domain_(domain) {}
+    bool operator()(const ReachingDefinition &a, const ReachingDefinition &b) const {
+        return a.first < b.first;
+    }
+
+    bool operator()(const ReachingDefinition &a, const MemoryLocation &b) const {
+        return a.first < b;
+    }
 
-    bool operator()(const ReachingDefinition &def) const {
-        return def.first.domain() == domain_;
+    bool operator()(const MemoryLocation &a, const ReachingDefinition &b) const {
+        return a < b.first;
     }
 };
 
 /**
- * Comparator establishing a total order on ReachingDefinition objects.
+ * Comparator ordering ReachingDefinition objects by domain only.
  */
-class Before: public std::binary_function<const ReachingDefinition &, const ReachingDefinition &, bool> {
+class DomainBefore {
     public:
 
     bool operator()(const ReachingDefinition &a, const ReachingDefinition &b) const {
-        return a.first < b.first;
+        return a.first.domain() < b.first.domain();
+    }
+
+    bool operator()(const ReachingDefinition &a, Domain b) const {
+        return a.first.domain() < b;
+    }
+
+    bool operator()(Domain a, const ReachingDefinition &b) const {
+        return a < b.first.domain();
     }
 };
 
+/**
+ * Sets a bit in a bit vector, growing it if necessary.
+ */
+void setBit(DefinitionNumbering::Bits &bits, std::size_t number) {
+    std::size_t word = number / DefinitionNumbering::WORD_BITS;
+    if (bits.size() <= word) {
+        bits.resize(word + 1, 0);
+    }
+    bits[word] |= DefinitionNumbering::Word(1) << (number % DefinitionNumbering::WORD_BITS);
+}
+
+/**
+ * Calls the functor for the number of each set bit in (a & b).
+ */
+template<class F>
+void forEachBit(const DefinitionNumbering::Bits &a, const DefinitionNumbering::Bits &b, F f) {
+    std::size_t size = std::min(a.size(), b.size());
+    for (std::size_t i = 0; i < size; ++i) {
+        DefinitionNumbering::Word word = a[i] & b[i];
+        for (std::size_t number = i * DefinitionNumbering::WORD_BITS; word; ++number, word >>= 1) {
+            if (word & 1) {
+                f(number);
+            }
+        }
+    }
+}
+
+/**
+ * \return True if the bit vector has no set bits.
+ */
+bool isZero(const DefinitionNumbering::Bits &bits) {
+    foreach (DefinitionNumbering::Word word, bits) {
+        if (word) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } // anonymous namespace
 
+std::size_t DefinitionNumbering::getNumber(const MemoryLocation &memoryLocation, const Term *term) {
+    assert(isNumbered(memoryLocation));
+    assert(term != NULL);
+
+    auto definition = std::make_pair(memoryLocation, term);
+    auto i = numbers_.find(definition);
+    if (i != numbers_.end()) {
+        return i->second;
+    }
+
+    std::size_t number = definitions_.size();
+    definitions_.push_back(definition);
+    numbers_[definition] = number;
+
+    auto j = exact_.find(memoryLocation);
+    if (j != exact_.end()) {
+        setBit(j->second, number);
+    }
+
+    Overlap overlap(memoryLocation);
+    for (auto k = overlapping_.begin(); k != overlapping_.end(); ++k) {
+        if (overlap(k->first)) {
+            setBit(k->second, number);
+        }
+    }
+
+    return number;
+}
+
+const DefinitionNumbering::Bits &DefinitionNumbering::getExact(const MemoryLocation &memoryLocation) {
+    auto i = exact_.find(memoryLocation);
+    if (i != exact_.end()) {
+        return i->second;
+    }
+
+    Bits &bits = exact_[memoryLocation];
+    for (std::size_t number = 0; number < definitions_.size(); ++number) {
+        if (definitions_[number].first == memoryLocation) {
+            setBit(bits, number);
+        }
+    }
+    return bits;
+}
+
+const DefinitionNumbering::Bits &DefinitionNumbering::getOverlapping(const MemoryLocation &memoryLocation) {
+    auto i = overlapping_.find(memoryLocation);
+    if (i != overlapping_.end()) {
+        return i->second;
+    }
+
+    Bits &bits = overlapping_[memoryLocation];
+    Overlap overlap(memoryLocation);
+    for (std::size_t number = 0; number < definitions_.size(); ++number) {
+        if (overlap(definitions_[number].first)) {
+            setBit(bits, number);
+        }
+    }
+    return bits;
+}
+
+ReachingDefinitions::ReachingDefinitions(DefinitionNumbering *numbering):
+    numbering_(numbering)
+{}
+
+void ReachingDefinitions::clear() {
+    registerDefinitions_.clear();
+    definitions_.reset();
+}
+
+bool ReachingDefinitions::empty() const {
+    return (!definitions_ || definitions_->empty()) && isZero(registerDefinitions_);
+}
+
+std::vector<ReachingDefinition> &ReachingDefinitions::modifiableDefinitions() {
+    if (!definitions_) {
+        definitions_ = std::make_shared<std::vector<ReachingDefinition> >();
+    } else if (definitions_.use_count() > 1) {
+        definitions_ = std::make_shared<std::vector<ReachingDefinition> >(*definitions_);
+    }
+    return *definitions_;
+}
+
 void ReachingDefinitions::addDefinition(const MemoryLocation &memoryLocation, const Term *term) {
     assert(memoryLocation.domain() != MemoryDomain::UNKNOWN);
 
     killDefinitions(memoryLocation);
-    
-    definitions_.push_back(ReachingDefinition(memoryLocation, std::vector<const Term *>(1, term)));
+
+    if (isNumbered(memoryLocation)) {
+        setBit(registerDefinitions_, numbering_->getNumber(memoryLocation, term));
+        return;
+    }
+
+    std::vector<ReachingDefinition> &definitions = modifiableDefinitions();
+    definitions.insert(
+        std::lower_bound(definitions.begin(), definitions.end(), memoryLocation, Before()),
+        ReachingDefinition(memoryLocation, std::vector<const Term *>(1, term)));
 }
 
 void ReachingDefinitions::killDefinitions(const MemoryLocation &memoryLocation) {
     assert(memoryLocation.domain() != MemoryDomain::UNKNOWN);
 
-    definitions_.erase(std::remove_if(definitions_.begin(), definitions_.end(), Overlap(memoryLocation)), definitions_.end());
+    if (isNumbered(memoryLocation)) {
+        const DefinitionNumbering::Bits &overlapping = numbering_->getOverlapping(memoryLocation);
+        std::size_t size = std::min(registerDefinitions_.size(), overlapping.size());
+        for (std::size_t i = 0; i < size; ++i) {
+            registerDefinitions_[i] &= ~overlapping[i];
+        }
+        return;
+    }
+
+    if (!definitions_) {
+        return;
+    }
+
+    /* Look for overlapping definitions without detaching shared storage. */
+    auto range = std::equal_range(definitions_->begin(), definitions_->end(), memoryLocation.domain(), DomainBefore());
+    auto first = std::find_if(range.first, range.second, Overlap(memoryLocation));
+    if (first == range.second) {
+        return;
+    }
+
+    std::size_t begin = first - definitions_->begin();
+    std::size_t end = range.second - definitions_->begin();
+
+    std::vector<ReachingDefinition> &definitions = modifiableDefinitions();
+    definitions.erase(
+        std::remove_if(definitions.begin() + begin, definitions.begin() + end, Overlap(memoryLocation)),
+        definitions.begin() + end);
 }
 
-const std::vector<const Term *> &ReachingDefinitions::getDefinitions(const MemoryLocation &memoryLocation) const {
-    foreach (const ReachingDefinition &definition, definitions_) {
-        if (definition.first == memoryLocation) {
-            return definition.second;
+void ReachingDefinitions::joinDefinitions(const MemoryLocation &memoryLocation, const std::vector<const Term *> &terms) {
+    assert(memoryLocation.domain() != MemoryDomain::UNKNOWN);
+
+    if (terms.empty()) {
+        return;
+    }
+
+    if (isNumbered(memoryLocation)) {
+        foreach (const Term *term, terms) {
+            setBit(registerDefinitions_, numbering_->getNumber(memoryLocation, term));
+        }
+        return;
+    }
+
+    std::vector<ReachingDefinition> &definitions = modifiableDefinitions();
+    auto i = std::lower_bound(definitions.begin(), definitions.end(), memoryLocation, Before());
+    if (i != definitions.end() && i->first == memoryLocation) {
+        std::vector<const Term *> result;
+        result.reserve(i->second.size() + terms.size());
+        std::set_union(i->second.begin(), i->second.end(), terms.begin(), terms.end(), std::back_inserter(result));
+        i->second.swap(result);
+    } else {
+        definitions.insert(i, ReachingDefinition(memoryLocation, terms));
+    }
+}
+
+std::vector<const Term *> ReachingDefinitions::getDefinitions(const MemoryLocation &memoryLocation) const {
+    std::vector<const Term *> result;
+
+    if (isNumbered(memoryLocation)) {
+        DefinitionNumbering *numbering = numbering_;
+        forEachBit(registerDefinitions_, numbering->getExact(memoryLocation), [&](std::size_t number) {
+            result.push_back(numbering->getDefinition(number).second);
+        });
+        std::sort(result.begin(), result.end());
+    } else if (definitions_) {
+        auto i = std::lower_bound(definitions_->begin(), definitions_->end(), memoryLocation, Before());
+        if (i != definitions_->end() && i->first == memoryLocation) {
+            result = i->second;
         }
     }
 
-    static const std::vector<const Term *> empty;
-    return empty;
+    return result;
 }
 
 std::vector<MemoryLocation> ReachingDefinitions::getDefinedMemoryLocationsWithin(Domain domain) const {
     std::vector<MemoryLocation> result;
-    result.reserve(definitions_.size());
 
-    foreach (const ReachingDefinition &definition, definitions_) {
-        if (definition.first.domain() == domain) {
-            result.push_back(definition.first);
+    if (isNumbered(domain)) {
+        DefinitionNumbering *numbering = numbering_;
+        forEachBit(registerDefinitions_, registerDefinitions_, [&](std::size_t number) {
+            const MemoryLocation &memoryLocation = numbering->getDefinition(number).first;
+            if (memoryLocation.domain() == domain) {
+                result.push_back(memoryLocation);
+            }
+        });
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    } else if (definitions_) {
+        auto range = std::equal_range(definitions_->begin(), definitions_->end(), domain, DomainBefore());
+
+        result.reserve(range.second - range.first);
+        for (auto i = range.first; i != range.second; ++i) {
+            result.push_back(i->first);
         }
     }
 
     return result;
 }
 
-void ReachingDefinitions::join(ReachingDefinitions &those) {
-    std::sort(definitions_.begin(), definitions_.end(), Before());
-    std::sort(those.definitions_.begin(), those.definitions_.end(), Before());
+std::vector<ReachingDefinition> ReachingDefinitions::getAllDefinitions() const {
+    std::vector<ReachingDefinition> result;
+
+    if (numbering_) {
+        std::vector<std::pair<MemoryLocation, const Term *> > registerDefinitions;
+
+        DefinitionNumbering *numbering = numbering_;
+        forEachBit(registerDefinitions_, registerDefinitions_, [&](std::size_t number) {
+            registerDefinitions.push_back(numbering->getDefinition(number));
+        });
+        std::sort(registerDefinitions.begin(), registerDefinitions.end());
+
+        for (std::size_t i = 0; i < registerDefinitions.size(); ++i) {
+            if (i == 0 || !(registerDefinitions[i].first == registerDefinitions[i - 1].first)) {
+                result.push_back(ReachingDefinition(registerDefinitions[i].first, std::vector<const Term *>()));
+            }
+            result.back().second.push_back(registerDefinitions[i].second);
+        }
+    }
+
+    if (definitions_ && !definitions_->empty()) {
+        std::vector<ReachingDefinition> merged;
+        merged.reserve(result.size() + definitions_->size());
+        std::merge(result.begin(), result.end(), definitions_->begin(), definitions_->end(), std::back_inserter(merged), Before());
+        result.swap(merged);
+    }
+
+    return result;
+}
+
+void ReachingDefinitions::join(const ReachingDefinitions &those) {
+    assert(numbering_ == those.numbering_ || isZero(those.registerDefinitions_));
+
+    if (registerDefinitions_.size() < those.registerDefinitions_.size()) {
+        registerDefinitions_.resize(those.registerDefinitions_.size(), 0);
+    }
+    for (std::size_t i = 0; i < those.registerDefinitions_.size(); ++i) {
+        registerDefinitions_[i] |= those.registerDefinitions_[i];
+    }
+
+    if (!those.definitions_ || those.definitions_->empty() || definitions_ == those.definitions_) {
+        return;
+    }
+
+    if (!definitions_ || definitions_->empty()) {
+        definitions_ = those.definitions_;
+        return;
+    }
 
     std::vector<ReachingDefinition> result;
-    result.reserve(definitions_.size() + those.definitions_.size());
+    result.reserve(definitions_->size() + those.definitions_->size());
 
-    std::vector<ReachingDefinition>::iterator i = definitions_.begin();
-    std::vector<ReachingDefinition>::iterator iend = definitions_.end();
+    auto i = definitions_->begin();
+    auto iend = definitions_->end();
 
-    std::vector<ReachingDefinition>::iterator j = those.definitions_.begin();
-    std::vector<ReachingDefinition>::iterator jend = those.definitions_.end();
+    auto j = those.definitions_->begin();
+    auto jend = those.definitions_->end();
 
     while (i != iend && j != jend) {
         if (Before()(*i, *j)) {
@@ -145,46 +403,67 @@ void ReachingDefinitions::join(ReachingDefinitions &those) {
         } else if (Before()(*j, *i)) {
             result.push_back(*j++);
         } else {
-            result.push_back(*i++);
-            std::vector<const Term *> &terms(result.back().second);
-            terms.insert(terms.end(), j->second.begin(), j->second.end());
-            std::sort(terms.begin(), terms.end());
-            terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+            if (i->second == j->second) {
+                result.push_back(*i);
+            } else {
+                result.push_back(ReachingDefinition(i->first, std::vector<const Term *>()));
+                std::vector<const Term *> &terms = result.back().second;
+                terms.reserve(i->second.size() + j->second.size());
+                std::set_union(i->second.begin(), i->second.end(), j->second.begin(), j->second.end(), std::back_inserter(terms));
+            }
+            ++i;
             ++j;
         }
     }
-    while (i != iend) {
-        result.push_back(*i++);
-    }
-    while (j != jend) {
-        result.push_back(*j++);
-    }
-
-    definitions_.swap(result);
-}
+    result.insert(result.end(), i, iend);
+    result.insert(result.end(), j, jend);
 
-void ReachingDefinitions::sort() {
-    std::sort(definitions_.begin(), definitions_.end(), Before());
-    foreach (ReachingDefinition &definition, definitions_) {
-        std::sort(definition.second.begin(), definition.second.end());
+    if (definitions_.use_count() > 1) {
+        definitions_ = std::make_shared<std::vector<ReachingDefinition> >();
     }
+    definitions_->swap(result);
 }
 
-bool ReachingDefinitions::operator==(ReachingDefinitions &those) {
-    sort();
-    those.sort();
+bool ReachingDefinitions::operator==(const ReachingDefinitions &those) const {
+    const DefinitionNumbering::Bits &shorter = registerDefinitions_.size() < those.registerDefinitions_.size() ? registerDefinitions_ : those.registerDefinitions_;
+    const DefinitionNumbering::Bits &longer = registerDefinitions_.size() < those.registerDefinitions_.size() ? those.registerDefinitions_ : registerDefinitions_;
 
-    return definitions_ == those.definitions_;
+    if (!std::equal(shorter.begin(), shorter.end(), longer.begin())) {
+        return false;
+    }
+    for (std::size_t i = shorter.size(); i < longer.size(); ++i) {
+        if (longer[i]) {
+            return false;
+        }
+    }
+
+    if (definitions_ == those.definitions_) {
+        return true;
+    }
+    bool thisEmpty = !definitions_ || definitions_->empty();
+    bool thoseEmpty = !those.definitions_ || those.definitions_->empty();
+    if (thisEmpty || thoseEmpty) {
+        return thisEmpty && thoseEmpty;
+    }
+    return *definitions_ == *those.definitions_;
 }
 
 void ReachingDefinitions::print(QTextStream &out) const {
     out << '{';
-    foreach (const ReachingDefinition &definition, definitions_) {
-        out << definition.first << ':';
-        foreach (const Term *term, definition.second) {
-            out << ' ' << *term;
+    if (numbering_) {
+        forEachBit(registerDefinitions_, registerDefinitions_, [&](std::size_t number) {
+            const std::pair<MemoryLocation, const Term *> &definition = numbering_->getDefinition(number);
+            out << definition.first << ": " << *definition.second << ';';
+        });
+    }
+    if (definitions_) {
+        foreach (const ReachingDefinition &definition, *definitions_) {
+            out << definition.first << ':';
+            foreach (const Term *term, definition.second) {
+                out << ' ' << *term;
+            }
+            out << ';';
         }
-        out << ';';
     }
     out << '}';
 }
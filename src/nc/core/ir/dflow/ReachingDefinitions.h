@@ -22,10 +22,18 @@
 
 #include <nc/config.h>
 
+#include <memory> /* std::shared_ptr */
 #include <vector>
 
+#include <cassert>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
 #include <nc/common/Printable.h>
 
+#include <nc/core/ir/MemoryDomain.h>
 #include <nc/core/ir/MemoryLocation.h>
 
 namespace nc {
@@ -41,18 +49,131 @@ namespace dflow {
  */
 typedef std::pair<MemoryLocation, std::vector<const Term *> > ReachingDefinition;
 
+/**
+ * Numbering of register definitions, i.e. pairs of a register memory location
+ * and a term defining it, shared by all the reaching definitions of one analysis.
+ *
+ * Definitions are numbered on first sight, because terms can be created
+ * during the analysis (e.g. by call analyzers). For every memory location
+ * looked up, the sets of definitions of exactly this location and of the
+ * locations overlapping it are cached as bit vectors and kept up to date
+ * when new definitions get their numbers.
+ */
+class DefinitionNumbering: boost::noncopyable {
+    public:
+
+    /** Type of a word of a bit vector. */
+    typedef boost::uint64_t Word;
+
+    /** Bit vector over definition numbers. Missing trailing words are zero. */
+    typedef std::vector<Word> Bits;
+
+    /** Number of bits in a word. */
+    static const std::size_t WORD_BITS = sizeof(Word) * 8;
+
+    private:
+
+    /** Definitions, indexed by their numbers. */
+    std::vector<std::pair<MemoryLocation, const Term *> > definitions_;
+
+    /** Mapping from a definition to its number. */
+    boost::unordered_map<std::pair<MemoryLocation, const Term *>, std::size_t> numbers_;
+
+    /** Mapping from a memory location to the definitions of this exact location. */
+    boost::unordered_map<MemoryLocation, Bits> exact_;
+
+    /** Mapping from a memory location to the definitions of overlapping locations. */
+    boost::unordered_map<MemoryLocation, Bits> overlapping_;
+
+    public:
+
+    /**
+     * \param memoryLocation Register memory location.
+     *
+     * \return True if definitions of this memory location are numbered.
+     */
+    static bool isNumbered(const MemoryLocation &memoryLocation) {
+        return MemoryDomain::FIRST_REGISTER <= memoryLocation.domain() && memoryLocation.domain() <= MemoryDomain::LAST_REGISTER;
+    }
+
+    /**
+     * \param memoryLocation Register memory location.
+     * \param term Valid pointer to the term defining it.
+     *
+     * \return Number of the definition, assigned if necessary.
+     */
+    std::size_t getNumber(const MemoryLocation &memoryLocation, const Term *term);
+
+    /**
+     * \param number Definition number.
+     *
+     * \return The definition with this number.
+     */
+    const std::pair<MemoryLocation, const Term *> &getDefinition(std::size_t number) const {
+        assert(number < definitions_.size());
+        return definitions_[number];
+    }
+
+    /**
+     * \param memoryLocation Register memory location.
+     *
+     * \return Numbers of the definitions of exactly this location.
+     */
+    const Bits &getExact(const MemoryLocation &memoryLocation);
+
+    /**
+     * \param memoryLocation Register memory location.
+     *
+     * \return Numbers of the definitions of the locations overlapping this one.
+     */
+    const Bits &getOverlapping(const MemoryLocation &memoryLocation);
+};
+
 /**
  * Reaching definitions.
+ *
+ * If constructed with a definition numbering, reaching definitions of
+ * registers are kept in a bit vector over the numbers of definitions,
+ * so that kills, joins and comparisons are word-wise operations.
+ *
+ * All other definitions are kept sorted by memory location, and the terms
+ * defining a memory location are kept sorted too. Copies share this
+ * storage until one of them is modified.
  */
 class ReachingDefinitions: public PrintableBase<ReachingDefinitions> {
-    std::vector<ReachingDefinition> definitions_; ///< The definitions: pairs of memory locations and sets of terms defining it.
+    /** Numbering of register definitions. Can be NULL. */
+    DefinitionNumbering *numbering_;
+
+    /** Numbers of the reaching register definitions. */
+    DefinitionNumbering::Bits registerDefinitions_;
+
+    /** The other definitions: pairs of memory locations and sets of terms defining it. Can be NULL, if empty. */
+    std::shared_ptr<std::vector<ReachingDefinition> > definitions_;
 
     public:
 
+    /**
+     * Constructs empty reaching definitions.
+     *
+     * \param numbering Pointer to the numbering of register definitions.
+     *                  If NULL, register definitions are kept as all the others.
+     */
+    explicit ReachingDefinitions(DefinitionNumbering *numbering = NULL);
+
+    /**
+     * \return Pointer to the numbering of register definitions. Can be NULL.
+     */
+    DefinitionNumbering *numbering() const { return numbering_; }
+
     /**
      * Clears the reaching definitions.
      */
-    void clear() { definitions_.clear(); }
+    void clear();
+
+    /**
+     * \return True, if there are no reaching definitions.
+     */
+    bool empty() const;
 
     /**
      * Adds a definition of memory location, removing all previous definitions of overlapping memory locations.
@@ -70,46 +191,79 @@ class ReachingDefinitions: public PrintableBase<ReachingDefinitions> {
     void killDefinitions(const MemoryLocation &memoryLocation);
 
     /**
-     * \return Definitions of given memory location.
+     * Adds definitions of a memory location without removing the definitions
+     * of overlapping memory locations, as join() does.
      *
      * \param[in] memoryLocation Memory location.
+     * \param[in] terms Sorted list of terms defining the memory location.
      */
-    const std::vector<const Term *> &getDefinitions(const MemoryLocation &memoryLocation) const;
+    void joinDefinitions(const MemoryLocation &memoryLocation, const std::vector<const Term *> &terms);
 
     /**
-     * \return All defined memory locations in the domain.
+     * \return Definitions of given memory location, sorted.
+     *
+     * \param[in] memoryLocation Memory location.
+     */
+    std::vector<const Term *> getDefinitions(const MemoryLocation &memoryLocation) const;
+
+    /**
+     * \return All defined memory locations in the domain, sorted by address.
      *
      * \param[in] domain Domain.
      */
     std::vector<MemoryLocation> getDefinedMemoryLocationsWithin(Domain domain) const;
 
     /**
-     * Adds given reaching definitions to the list of known reaching definitions.
-     *
-     * \param[in] those Reaching definitions.
+     * \return All the reaching definitions, sorted by memory location.
      */
-    void join(ReachingDefinitions &those);
+    std::vector<ReachingDefinition> getAllDefinitions() const;
 
     /**
-     * Sorts reaching definitions so that two sorted instances of reaching definitions can be compared for equality.
+     * Adds given reaching definitions to the list of known reaching definitions.
+     * Both must use the same numbering of register definitions.
+     *
+     * \param[in] those Reaching definitions.
      */
-    void sort();
+    void join(const ReachingDefinitions &those);
 
     /**
      * \return True, if these and given reaching definitions are the same.
      *
      * \param[in] those Reaching definitions.
      */
-    bool operator==(ReachingDefinitions &those);
+    bool operator==(const ReachingDefinitions &those) const;
 
     /**
      * \return True, if these and given reaching definitions are different.
      *
      * \param[in] those Reaching definitions.
      */
-    bool operator!=(ReachingDefinitions &those) { return !(*this == those); }
+    bool operator!=(const ReachingDefinitions &those) const { return !(*this == those); }
 
     void print(QTextStream &out) const;
+
+    private:
+
+    /**
+     * \param memoryLocation Memory location.
+     *
+     * \return True if the definitions of the memory location are kept in the bit vector.
+     */
+    bool isNumbered(const MemoryLocation &memoryLocation) const {
+        return numbering_ && DefinitionNumbering::isNumbered(memoryLocation);
+    }
+
+    /**
+     * \return True if the domain's definitions are kept in the bit vector.
+     */
+    bool isNumbered(Domain domain) const {
+        return numbering_ && MemoryDomain::FIRST_REGISTER <= domain && domain <= MemoryDomain::LAST_REGISTER;
+    }
+
+    /**
+     * \return The definitions, copied before if they are shared with other instances.
+     */
+    std::vector<ReachingDefinition> &modifiableDefinitions();
 };
 
 } // namespace dflow
@@ -22,7 +22,10 @@
 
 #include <nc/config.h>
 
+#include <vector>
+
 #include "ReachingDefinitions.h"
+#include "SsaForm.h"
 
 namespace nc {
 namespace core {
@@ -41,6 +44,7 @@ class SimulationContext {
     ReachingDefinitions definitions_; ///< Reaching definitions.
     const Function *function_; ///< Function being simulated.
     bool fixpointReached_; ///< Whether stationary point in reaching definitions is reached.
+    const SsaForm *ssaForm_; ///< SSA form giving the definitions of reads, if any.
 
     public:
 
@@ -51,11 +55,16 @@ class SimulationContext {
      * \param function                  Pointer to the function being simulated. Can be NULL.
      * \param fixpointReached           Flag which is true if reaching definitions didn't change
      *                                  during last iteration of function's simulation.
+     * \param numbering                 Pointer to the numbering of register definitions
+     *                                  shared by the analysis. Can be NULL.
      */
-    SimulationContext(DataflowAnalyzer &analyzer, const Function *function = NULL, bool fixpointReached = false):
+    SimulationContext(DataflowAnalyzer &analyzer, const Function *function = NULL, bool fixpointReached = false,
+                      DefinitionNumbering *numbering = NULL):
         analyzer_(analyzer),
+        definitions_(numbering),
         function_(function),
-        fixpointReached_(fixpointReached)
+        fixpointReached_(fixpointReached),
+        ssaForm_(NULL)
     {}
 
     /**
@@ -87,6 +96,34 @@ class SimulationContext {
      * \return Reaching definitions.
      */
     const ReachingDefinitions &definitions() const { return definitions_; }
+
+    /**
+     * \return Pointer to the SSA form giving the definitions of reads. Can be NULL.
+     */
+    const SsaForm *ssaForm() const { return ssaForm_; }
+
+    /**
+     * Sets the SSA form giving the definitions of reads. While it is set,
+     * reads do not look at the reaching definitions, and writes and kills
+     * do not change them.
+     *
+     * \param ssaForm Pointer to the SSA form. Can be NULL.
+     */
+    void setSsaForm(const SsaForm *ssaForm) { ssaForm_ = ssaForm; }
+
+    /**
+     * \param term Valid pointer to a term reading a memory location.
+     * \param memoryLocation The memory location.
+     *
+     * \return Sorted list of the definitions reaching the read.
+     */
+    std::vector<const Term *> getDefinitions(const Term *term, const MemoryLocation &memoryLocation) const {
+        if (ssaForm_) {
+            return ssaForm_->getDefinitions(term, memoryLocation);
+        } else {
+            return definitions_.getDefinitions(memoryLocation);
+        }
+    }
 };
 
 } // namespace dflow
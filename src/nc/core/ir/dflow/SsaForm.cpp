@@ -0,0 +1,407 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SsaForm.h"
+
+#include <algorithm>
+
+#include <boost/unordered_map.hpp>
+
+#include <nc/common/Foreach.h>
+
+#include <nc/core/ir/CFG.h>
+#include <nc/core/ir/DominatorTree.h>
+#include <nc/core/ir/Term.h>
+
+#include "ReachingDefinitions.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace dflow {
+
+SsaForm::SsaForm(const CFG &cfg, const DominatorTree &dominatorTree, const BasicBlock *entry, const std::vector<Step> &steps):
+    snapshots_(steps.size())
+{
+    assert(entry != NULL);
+    assert(dominatorTree.kind() == DominatorTree::DOMINATORS);
+
+    if (!dominatorTree.contains(entry)) {
+        return;
+    }
+
+    /*
+     * Number the accessed and changed memory locations.
+     */
+    std::vector<MemoryLocation> locations;
+
+    foreach (const Step &step, steps) {
+        foreach (const Access &access, step.accesses) {
+            locations.push_back(access.memoryLocation);
+        }
+        foreach (const Change &change, step.changes) {
+            locations.push_back(change.memoryLocation);
+        }
+    }
+
+    std::sort(locations.begin(), locations.end());
+    locations.erase(std::unique(locations.begin(), locations.end()), locations.end());
+
+    auto getNumber = [&](const MemoryLocation &memoryLocation) -> std::size_t {
+        auto i = std::lower_bound(locations.begin(), locations.end(), memoryLocation);
+        assert(i != locations.end() && *i == memoryLocation);
+        return i - locations.begin();
+    };
+
+    /*
+     * For every location, find the numbers of the locations overlapping it,
+     * including itself. Locations are sorted by domain and address, so the
+     * locations overlapping a given one from the right follow it closely.
+     */
+    std::vector<std::vector<std::size_t> > overlapping(locations.size());
+
+    for (std::size_t i = 0; i < locations.size(); ++i) {
+        overlapping[i].push_back(i);
+
+        for (std::size_t j = i + 1; j < locations.size() &&
+             locations[j].domain() == locations[i].domain() &&
+             locations[j].addr() < locations[i].endAddr(); ++j)
+        {
+            overlapping[i].push_back(j);
+            overlapping[j].push_back(i);
+        }
+    }
+
+    /*
+     * Find the steps of each basic block.
+     */
+    boost::unordered_map<const BasicBlock *, std::pair<std::size_t, std::size_t> > block2steps;
+
+    for (std::size_t i = 0; i < steps.size(); ++i) {
+        auto &range = block2steps[steps[i].basicBlock];
+        if (range.first == range.second) {
+            range.first = i;
+        }
+        assert(range.second == 0 || range.second == i);
+        range.second = i + 1;
+    }
+
+    /*
+     * Find the basic blocks changing each location.
+     */
+    std::vector<std::vector<const BasicBlock *> > definitionSites(locations.size());
+
+    auto addDefinitionSite = [&](std::size_t number, const BasicBlock *basicBlock) {
+        std::vector<const BasicBlock *> &sites = definitionSites[number];
+        if (sites.empty() || sites.back() != basicBlock) {
+            sites.push_back(basicBlock);
+        }
+    };
+
+    foreach (const Step &step, steps) {
+        if (!dominatorTree.contains(step.basicBlock)) {
+            continue;
+        }
+        foreach (const Access &access, step.accesses) {
+            if (access.term->isWrite() || access.term->isKill()) {
+                foreach (std::size_t number, overlapping[getNumber(access.memoryLocation)]) {
+                    addDefinitionSite(number, step.basicBlock);
+                }
+            }
+        }
+        foreach (const Change &change, step.changes) {
+            addDefinitionSite(getNumber(change.memoryLocation), step.basicBlock);
+        }
+    }
+
+    /*
+     * Place phi functions.
+     */
+    boost::unordered_map<const BasicBlock *, std::vector<Phi *> > block2phis;
+
+    for (std::size_t number = 0; number < locations.size(); ++number) {
+        if (definitionSites[number].empty()) {
+            continue;
+        }
+        foreach (const BasicBlock *basicBlock, dominatorTree.getIteratedDominanceFrontier(definitionSites[number])) {
+            phis_.push_back(std::unique_ptr<Phi>(new Phi(basicBlock, locations[number])));
+            phis_.back()->locationNumber_ = number;
+            block2phis[basicBlock].push_back(phis_.back().get());
+        }
+    }
+
+    /*
+     * Rename: walk the dominator tree, keeping the current definition of each
+     * location and a log of changes to undo when leaving a subtree.
+     */
+    std::vector<Definition> currentDefinitions(locations.size());
+    std::vector<std::pair<std::size_t, Definition> > undoLog;
+
+    auto define = [&](std::size_t number, const Definition &definition) {
+        undoLog.push_back(std::make_pair(number, currentDefinitions[number]));
+        currentDefinitions[number] = definition;
+    };
+
+    /* Explicit DFS stack: a basic block, the index of its next child, and the undo log size on entry. */
+    struct Frame {
+        const BasicBlock *basicBlock;
+        std::size_t childIndex;
+        std::size_t undoLogSize;
+    };
+    std::vector<Frame> stack;
+
+    auto enter = [&](const BasicBlock *basicBlock) {
+        Frame frame = { basicBlock, 0, undoLog.size() };
+        stack.push_back(frame);
+
+        auto phis = block2phis.find(basicBlock);
+        if (phis != block2phis.end()) {
+            foreach (const Phi *phi, phis->second) {
+                define(phi->locationNumber_, Definition(phi));
+            }
+        }
+
+        auto range = block2steps.find(basicBlock);
+        if (range != block2steps.end()) {
+            for (std::size_t i = range->second.first; i < range->second.second; ++i) {
+                const Step &step = steps[i];
+
+                if (step.isOpaque) {
+                    for (std::size_t number = 0; number < locations.size(); ++number) {
+                        if (!currentDefinitions[number].isUndefined()) {
+                            snapshots_[i].push_back(std::make_pair(locations[number], currentDefinitions[number]));
+                        }
+                    }
+
+                    foreach (const Change &change, step.changes) {
+                        std::size_t number = getNumber(change.memoryLocation);
+
+                        std::vector<Definition> operands;
+                        if (change.keep && !currentDefinitions[number].isUndefined()) {
+                            operands.push_back(currentDefinitions[number]);
+                        }
+                        foreach (const Term *term, change.terms) {
+                            operands.push_back(Definition(term));
+                        }
+
+                        if (operands.size() <= 1) {
+                            define(number, operands.empty() ? Definition() : operands.front());
+                        } else {
+                            phis_.push_back(std::unique_ptr<Phi>(new Phi(basicBlock, change.memoryLocation)));
+                            phis_.back()->locationNumber_ = number;
+                            phis_.back()->operands_.swap(operands);
+                            define(number, Definition(phis_.back().get()));
+                        }
+                    }
+                } else {
+                    foreach (const Access &access, step.accesses) {
+                        std::size_t number = getNumber(access.memoryLocation);
+
+                        if (access.term->isRead()) {
+                            auto inserted = readIndex_.insert(access.term);
+                            if (inserted.second) {
+                                reads_.push_back(std::make_pair(access.memoryLocation, currentDefinitions[number]));
+                            } else {
+                                reads_[inserted.first] = std::make_pair(access.memoryLocation, currentDefinitions[number]);
+                            }
+                        }
+                        if (access.term->isWrite() || access.term->isKill()) {
+                            foreach (std::size_t overlappingNumber, overlapping[number]) {
+                                if (!currentDefinitions[overlappingNumber].isUndefined()) {
+                                    define(overlappingNumber, Definition());
+                                }
+                            }
+                            if (!access.term->isKill()) {
+                                define(number, Definition(access.term));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        foreach (const BasicBlock *successor, cfg.getSuccessors(basicBlock)) {
+            auto phis = block2phis.find(successor);
+            if (phis != block2phis.end()) {
+                foreach (Phi *phi, phis->second) {
+                    const Definition &definition = currentDefinitions[phi->locationNumber_];
+                    if (!definition.isUndefined()) {
+                        phi->operands_.push_back(definition);
+                    }
+                }
+            }
+        }
+    };
+
+    enter(entry);
+
+    while (!stack.empty()) {
+        Frame &frame = stack.back();
+        const std::vector<const BasicBlock *> &children = dominatorTree.getChildren(frame.basicBlock);
+
+        if (frame.childIndex < children.size()) {
+            enter(children[frame.childIndex++]);
+        } else {
+            while (undoLog.size() > frame.undoLogSize) {
+                currentDefinitions[undoLog.back().first] = undoLog.back().second;
+                undoLog.pop_back();
+            }
+            stack.pop_back();
+        }
+    }
+
+    flatten();
+}
+
+SsaForm::~SsaForm() {}
+
+void SsaForm::flatten() {
+    /*
+     * Phi functions reaching each other form strongly connected components,
+     * all the phi functions of which are reached by the same terms. The
+     * components are found by Tarjan's algorithm, which completes every
+     * component after the components it reaches. The terms of a component
+     * are the union of the terms of its operands: phi functions of the
+     * component itself contribute nothing, because their terms are not
+     * computed yet, and the other ones are already done.
+     */
+    const std::size_t NOT_VISITED = static_cast<std::size_t>(-1);
+
+    boost::unordered_map<const Phi *, std::size_t> phi2index;
+    for (std::size_t i = 0; i < phis_.size(); ++i) {
+        phi2index[phis_[i].get()] = i;
+    }
+
+    std::vector<std::size_t> preorder(phis_.size(), NOT_VISITED);
+    std::vector<std::size_t> lowlink(phis_.size());
+    std::vector<bool> onStack(phis_.size());
+    std::vector<std::size_t> componentStack;
+    std::size_t counter = 0;
+
+    /* Explicit DFS stack: index of a phi function and the index of its next operand. */
+    std::vector<std::pair<std::size_t, std::size_t> > stack;
+
+    auto visit = [&](std::size_t index) {
+        preorder[index] = lowlink[index] = counter++;
+        componentStack.push_back(index);
+        onStack[index] = true;
+        stack.push_back(std::make_pair(index, 0));
+    };
+
+    for (std::size_t root = 0; root < phis_.size(); ++root) {
+        if (preorder[root] != NOT_VISITED) {
+            continue;
+        }
+
+        visit(root);
+
+        while (!stack.empty()) {
+            std::size_t index = stack.back().first;
+            const std::vector<Definition> &operands = phis_[index]->operands_;
+
+            if (stack.back().second < operands.size()) {
+                const Definition &operand = operands[stack.back().second++];
+                if (operand.phi()) {
+                    std::size_t operandIndex = phi2index[operand.phi()];
+                    if (preorder[operandIndex] == NOT_VISITED) {
+                        visit(operandIndex);
+                    } else if (onStack[operandIndex]) {
+                        lowlink[index] = std::min(lowlink[index], preorder[operandIndex]);
+                    }
+                }
+                continue;
+            }
+
+            stack.pop_back();
+            if (!stack.empty()) {
+                std::size_t parent = stack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[index]);
+            }
+
+            if (lowlink[index] != preorder[index]) {
+                continue;
+            }
+
+            std::size_t componentStart = std::find(componentStack.begin(), componentStack.end(), index) - componentStack.begin();
+
+            std::vector<const Term *> terms;
+            for (std::size_t i = componentStart; i < componentStack.size(); ++i) {
+                foreach (const Definition &operand, phis_[componentStack[i]]->operands_) {
+                    if (operand.term()) {
+                        terms.push_back(operand.term());
+                    } else {
+                        terms.insert(terms.end(), operand.phi()->terms().begin(), operand.phi()->terms().end());
+                    }
+                }
+            }
+
+            std::sort(terms.begin(), terms.end());
+            terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+            for (std::size_t i = componentStart; i < componentStack.size(); ++i) {
+                phis_[componentStack[i]]->terms_ = terms;
+                onStack[componentStack[i]] = false;
+            }
+            componentStack.resize(componentStart);
+        }
+    }
+}
+
+SsaForm::Definition SsaForm::getDefinition(const Term *term, const MemoryLocation &memoryLocation) const {
+    assert(term != NULL);
+
+    std::size_t number = readIndex_.find(term);
+    if (number != TermIndex::NOT_FOUND && reads_[number].first == memoryLocation) {
+        return reads_[number].second;
+    }
+    return Definition();
+}
+
+std::vector<const Term *> SsaForm::getDefinitions(const Term *term, const MemoryLocation &memoryLocation) const {
+    Definition definition = getDefinition(term, memoryLocation);
+
+    if (definition.term()) {
+        return std::vector<const Term *>(1, definition.term());
+    } else if (definition.phi()) {
+        return definition.phi()->terms();
+    } else {
+        return std::vector<const Term *>();
+    }
+}
+
+void SsaForm::getReachingDefinitions(std::size_t step, ReachingDefinitions &definitions) const {
+    assert(step < snapshots_.size());
+
+    foreach (const auto &pair, snapshots_[step]) {
+        if (pair.second.term()) {
+            definitions.joinDefinitions(pair.first, std::vector<const Term *>(1, pair.second.term()));
+        } else {
+            definitions.joinDefinitions(pair.first, pair.second.phi()->terms());
+        }
+    }
+}
+
+} // namespace dflow
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,302 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <nc/core/ir/MemoryLocation.h>
+#include <nc/core/ir/TermIndex.h>
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class BasicBlock;
+class CFG;
+class DominatorTree;
+class Term;
+
+namespace dflow {
+
+class ReachingDefinitions;
+
+/**
+ * Static single assignment form of the accesses to the memory locations
+ * tracked by dataflow analysis, i.e. registers and stack locations.
+ *
+ * The input is the sequence of steps of the simulation of a function's
+ * basic blocks. A plain step lists the accesses of terms to memory
+ * locations, in the order of simulation, and follows the rules of
+ * ReachingDefinitions: a read gets the definitions of exactly its memory
+ * location, a write kills the definitions of the overlapping locations and
+ * defines its own one, a kill kills them all. An opaque step, e.g. the
+ * simulation of a call by a call analyzer, is described by the changes it
+ * makes to the definitions; the definitions reaching it can be turned back
+ * into ReachingDefinitions.
+ *
+ * Phi functions are placed at the iterated dominance frontiers of the basic
+ * blocks changing a memory location, and reads are renamed by a walk over
+ * the dominator tree. Phi functions are kept aside and do not change the
+ * intermediate representation. Basic blocks unreachable from the entry
+ * are not covered.
+ */
+class SsaForm: boost::noncopyable {
+    public:
+
+    class Phi;
+
+    /**
+     * Definition reaching a read: a term, a phi function, or nothing.
+     */
+    class Definition {
+        const Term *term_; ///< Defining term.
+        const Phi *phi_; ///< Defining phi function.
+
+        public:
+
+        /**
+         * Constructs an undefined definition.
+         */
+        Definition(): term_(NULL), phi_(NULL) {}
+
+        /**
+         * Constructs a definition by a term.
+         *
+         * \param term Valid pointer to a term.
+         */
+        explicit Definition(const Term *term): term_(term), phi_(NULL) { assert(term != NULL); }
+
+        /**
+         * Constructs a definition by a phi function.
+         *
+         * \param phi Valid pointer to a phi function.
+         */
+        explicit Definition(const Phi *phi): term_(NULL), phi_(phi) { assert(phi != NULL); }
+
+        /**
+         * \return Pointer to the defining term. Can be NULL.
+         */
+        const Term *term() const { return term_; }
+
+        /**
+         * \return Pointer to the defining phi function. Can be NULL.
+         */
+        const Phi *phi() const { return phi_; }
+
+        /**
+         * \return True if the location is defined neither by a term nor by a phi function.
+         */
+        bool isUndefined() const { return term_ == NULL && phi_ == NULL; }
+    };
+
+    /**
+     * Phi function merging the definitions of a memory location coming from
+     * the predecessors of a basic block, or the definitions kept and added
+     * by an opaque step.
+     */
+    class Phi: boost::noncopyable {
+        const BasicBlock *basicBlock_; ///< Basic block the phi function is placed in.
+        MemoryLocation memoryLocation_; ///< Merged memory location.
+        std::size_t locationNumber_; ///< Number of the merged memory location.
+        std::vector<Definition> operands_; ///< Merged definitions.
+        std::vector<const Term *> terms_; ///< Sorted list of the terms reaching the phi function.
+
+        friend class SsaForm;
+
+        public:
+
+        /**
+         * Constructor.
+         *
+         * \param basicBlock Valid pointer to the basic block.
+         * \param memoryLocation Merged memory location.
+         */
+        Phi(const BasicBlock *basicBlock, const MemoryLocation &memoryLocation):
+            basicBlock_(basicBlock), memoryLocation_(memoryLocation), locationNumber_(0)
+        {
+            assert(basicBlock != NULL);
+        }
+
+        /**
+         * \return Valid pointer to the basic block the phi function is placed in.
+         */
+        const BasicBlock *basicBlock() const { return basicBlock_; }
+
+        /**
+         * \return Merged memory location.
+         */
+        const MemoryLocation &memoryLocation() const { return memoryLocation_; }
+
+        /**
+         * \return Merged definitions. Undefined ones are omitted.
+         */
+        const std::vector<Definition> &operands() const { return operands_; }
+
+        /**
+         * \return Sorted list of the terms reaching the phi function
+         *         through any number of phi functions.
+         */
+        const std::vector<const Term *> &terms() const { return terms_; }
+    };
+
+    /**
+     * Access of a term to a memory location. The kind of the access
+     * is given by the term's flags.
+     */
+    struct Access {
+        const Term *term; ///< Valid pointer to the accessing term.
+        MemoryLocation memoryLocation; ///< Accessed memory location.
+
+        Access(const Term *term, const MemoryLocation &memoryLocation):
+            term(term), memoryLocation(memoryLocation)
+        {}
+
+        bool operator==(const Access &that) const {
+            return term == that.term && memoryLocation == that.memoryLocation;
+        }
+    };
+
+    /**
+     * Change of the definitions of a memory location made by an opaque step.
+     * The new definitions are the given terms, plus the old definitions if
+     * they are kept. A change without terms that keeps nothing kills the
+     * definitions.
+     */
+    struct Change {
+        MemoryLocation memoryLocation; ///< Changed memory location.
+        bool keep; ///< Whether the old definitions are kept.
+        std::vector<const Term *> terms; ///< Sorted list of the added definitions.
+
+        Change(const MemoryLocation &memoryLocation, bool keep, const std::vector<const Term *> &terms):
+            memoryLocation(memoryLocation), keep(keep), terms(terms)
+        {}
+
+        bool operator==(const Change &that) const {
+            return memoryLocation == that.memoryLocation && keep == that.keep && terms == that.terms;
+        }
+    };
+
+    /**
+     * Step of the simulation of a basic block.
+     */
+    struct Step {
+        const BasicBlock *basicBlock; ///< Valid pointer to the basic block.
+        bool isOpaque; ///< Whether the step is described by changes instead of accesses.
+        std::vector<Access> accesses; ///< Accesses done by a plain step.
+        std::vector<Change> changes; ///< Changes done by an opaque step.
+
+        Step(const BasicBlock *basicBlock, bool isOpaque):
+            basicBlock(basicBlock), isOpaque(isOpaque)
+        {}
+
+        bool operator==(const Step &that) const {
+            return basicBlock == that.basicBlock && isOpaque == that.isOpaque &&
+                   accesses == that.accesses && changes == that.changes;
+        }
+
+        bool operator!=(const Step &that) const { return !(*this == that); }
+    };
+
+    private:
+
+    /** All phi functions. */
+    std::vector<std::unique_ptr<Phi> > phis_;
+
+    /** Numbers of the covered reads. */
+    TermIndex readIndex_;
+
+    /** Memory locations and reaching definitions of the covered reads, by number. */
+    std::vector<std::pair<MemoryLocation, Definition> > reads_;
+
+    /** Definitions of the tracked memory locations reaching the opaque steps, by step index. */
+    std::vector<std::vector<std::pair<MemoryLocation, Definition> > > snapshots_;
+
+    public:
+
+    /**
+     * Builds the SSA form.
+     *
+     * \param cfg Control flow graph.
+     * \param dominatorTree Dominator tree built for this control flow graph.
+     * \param entry Valid pointer to the entry basic block.
+     * \param steps Steps of the simulation. The steps of a basic block
+     *              must be consecutive and in the order of simulation.
+     */
+    SsaForm(const CFG &cfg, const DominatorTree &dominatorTree, const BasicBlock *entry, const std::vector<Step> &steps);
+
+    /**
+     * Destructor.
+     */
+    ~SsaForm();
+
+    /**
+     * \return All the phi functions.
+     */
+    const std::vector<std::unique_ptr<Phi> > &phis() const { return phis_; }
+
+    /**
+     * \param term Valid pointer to a term.
+     * \param memoryLocation Memory location read by the term.
+     *
+     * \return The definition reaching the read. Undefined if the term
+     *         is not a covered read of the given memory location.
+     */
+    Definition getDefinition(const Term *term, const MemoryLocation &memoryLocation) const;
+
+    /**
+     * \param term Valid pointer to a term.
+     * \param memoryLocation Memory location read by the term.
+     *
+     * \return Sorted list of the terms reaching the read through any
+     *         number of phi functions. Empty if the term is not a covered
+     *         read of the given memory location.
+     */
+    std::vector<const Term *> getDefinitions(const Term *term, const MemoryLocation &memoryLocation) const;
+
+    /**
+     * Adds the definitions reaching an opaque step to the given
+     * reaching definitions.
+     *
+     * \param step Index of an opaque step.
+     * \param definitions Reaching definitions.
+     */
+    void getReachingDefinitions(std::size_t step, ReachingDefinitions &definitions) const;
+
+    private:
+
+    /**
+     * Computes the terms reaching every phi function.
+     */
+    void flatten();
+};
+
+} // namespace dflow
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
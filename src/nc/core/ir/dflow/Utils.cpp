@@ -53,7 +53,7 @@ const Term *getFirstCopy(const Term *term, const Dataflow &dataflow) {
                 break;
             }
         } else if (term->isRead()) {
-            const std::vector<const Term *> &definitions = dataflow.getDefinitions(term);
+            auto definitions = dataflow.getDefinitions(term);
 
             if (definitions.size() == 1) {
                 term = definitions.front();
@@ -149,6 +149,18 @@ void Value::join(const Value &that) {
     }
 }
 
+bool Value::operator==(const Value &that) const {
+    return size_ == that.size_ &&
+           isConstant() == that.isConstant() &&
+           isNonconstant() == that.isNonconstant() &&
+           (!isConstant() || constantValue().value() == that.constantValue().value()) &&
+           isStackOffset() == that.isStackOffset() &&
+           isNotStackOffset() == that.isNotStackOffset() &&
+           (!isStackOffset() || stackOffset().value() == that.stackOffset().value()) &&
+           isMultiplication() == that.isMultiplication() &&
+           isNotMultiplication() == that.isNotMultiplication();
+}
+
 } // namespace dflow
 } // namespace ir
 } // namespace core
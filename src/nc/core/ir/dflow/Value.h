@@ -169,6 +169,20 @@ class Value {
      * \param[in] value Another value.
      */
     void join(const Value &value);
+
+    /**
+     * \param[in] that Another value.
+     *
+     * \return True if the two values have the same observable traits.
+     */
+    bool operator==(const Value &that) const;
+
+    /**
+     * \param[in] that Another value.
+     *
+     * \return True if the two values have different observable traits.
+     */
+    bool operator!=(const Value &that) const { return !(*this == that); }
 };
 
 } // namespace dflow
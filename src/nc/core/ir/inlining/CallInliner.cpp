@@ -38,9 +38,18 @@
 namespace nc { namespace core { namespace ir { namespace inlining {
 
 void CallInliner::perform(Function *receivingFunction, const Call *call, const Function *inlinedFunction) const {
-    /* Split call->basicBlock(). */
+    /* The function's code is going to be modified: get private copies of shared basic blocks. */
+    auto unshared = receivingFunction->unshare();
+
+    /* Find the basic block containing the call. */
     BasicBlock *leadIn = call->basicBlock();
-    auto leadOut = leadIn->split(boost::find(leadIn->statements(), call) - leadIn->statements().begin() + 1, boost::none);
+    std::size_t callIndex = boost::find(leadIn->statements(), call) - leadIn->statements().begin();
+    if (BasicBlock *clone = nc::find(unshared, leadIn)) {
+        leadIn = clone;
+    }
+
+    /* Split it. */
+    auto leadOut = leadIn->split(callIndex + 1, boost::none);
 
     /* Clone the basic blocks of inlined function. */
     auto clones = FunctionsGenerator::cloneIntoFunction(inlinedFunction->basicBlocks(), receivingFunction);
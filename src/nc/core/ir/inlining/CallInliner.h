@@ -40,9 +40,11 @@ public:
 
     /**
      * Inlines one function into another.
+     * Shared basic blocks of the receiving function are unshared first.
      *
      * \param[in] receivingFunction Function to inline into.
-     * \param[in] call Call to replace with inlined function.
+     * \param[in] call Call to replace with inlined function. Must belong to a basic block
+     *                 of the receiving function, possibly a shared one.
      * \param[in] inlinedFunction Inlined function itself.
      */
     virtual void perform(Function *receivingFunction, const Call *call, const Function *inlinedFunction) const;
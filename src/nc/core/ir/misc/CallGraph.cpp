@@ -0,0 +1,183 @@
+//
+// SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+// Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+// Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+//
+// This file is part of SmartDec decompiler.
+//
+// SmartDec decompiler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SmartDec decompiler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "CallGraph.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Function.h>
+#include <nc/core/ir/Functions.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+#include <nc/core/ir/calls/CallsData.h>
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace misc {
+
+CallGraph::CallGraph(const Functions *functions, const calls::CallsData *callsData) {
+    assert(functions != NULL);
+
+    foreach (const Function *function, functions->functions()) {
+        auto &callees = callees_[function];
+
+        foreach (const BasicBlock *basicBlock, function->basicBlocks()) {
+            foreach (const Statement *statement, basicBlock->statements()) {
+                if (const Call *call = statement->as<Call>()) {
+                    boost::optional<ByteAddr> address;
+                    if (callsData) {
+                        address = callsData->getCalledAddress(function, call);
+                    }
+                    if (!address) {
+                        if (const Constant *constant = call->target()->asConstant()) {
+                            address = constant->value().value();
+                        }
+                    }
+                    if (address) {
+                        foreach (const Function *callee, functions->getFunctionsAtAddress(*address)) {
+                            if (!nc::contains(callees, callee)) {
+                                callees.push_back(callee);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    computeComponents(functions);
+    computeLevels();
+}
+
+const std::vector<const Function *> &CallGraph::getCallees(const Function *function) const {
+    assert(function != NULL);
+
+    return nc::find(callees_, function);
+}
+
+void CallGraph::computeComponents(const Functions *functions) {
+    struct VertexInfo {
+        std::size_t index; ///< Number of the vertex in DFS preorder.
+        std::size_t lowlink; ///< Smallest index of a vertex on the stack reachable from this one.
+        bool onStack; ///< True iff the vertex is on the stack of the current components.
+    };
+
+    boost::unordered_map<const Function *, VertexInfo> infos;
+    std::vector<const Function *> stack;
+
+    /* Explicit DFS stack: a vertex and the index of its next callee to visit. */
+    std::vector<std::pair<const Function *, std::size_t>> path;
+
+    auto enter = [&](const Function *function) {
+        VertexInfo &info = infos[function];
+        info.index = infos.size() - 1;
+        info.lowlink = info.index;
+        info.onStack = true;
+
+        stack.push_back(function);
+        path.push_back(std::make_pair(function, 0));
+    };
+
+    foreach (const Function *root, functions->functions()) {
+        if (nc::contains(infos, root)) {
+            continue;
+        }
+
+        enter(root);
+
+        while (!path.empty()) {
+            const Function *function = path.back().first;
+            const std::vector<const Function *> &callees = getCallees(function);
+
+            if (path.back().second < callees.size()) {
+                const Function *callee = callees[path.back().second++];
+
+                auto i = infos.find(callee);
+                if (i == infos.end()) {
+                    enter(callee);
+                } else if (i->second.onStack) {
+                    VertexInfo &info = infos[function];
+                    info.lowlink = std::min(info.lowlink, i->second.index);
+                }
+                continue;
+            }
+
+            path.pop_back();
+
+            const VertexInfo &info = infos[function];
+            if (!path.empty()) {
+                VertexInfo &parentInfo = infos[path.back().first];
+                parentInfo.lowlink = std::min(parentInfo.lowlink, info.lowlink);
+            }
+
+            if (info.lowlink == info.index) {
+                auto begin = std::find(stack.begin(), stack.end(), function);
+                assert(begin != stack.end());
+
+                components_.push_back(Component(begin, stack.end()));
+                foreach (const Function *member, components_.back()) {
+                    infos[member].onStack = false;
+                }
+                stack.erase(begin, stack.end());
+            }
+        }
+    }
+
+    assert(stack.empty());
+}
+
+void CallGraph::computeLevels() {
+    boost::unordered_map<const Function *, std::size_t> function2level;
+
+    /* All the components called by a component precede it in components_. */
+    foreach (const Component &component, components_) {
+        std::size_t level = 0;
+        foreach (const Function *function, component) {
+            foreach (const Function *callee, getCallees(function)) {
+                if (auto calleeLevel = nc::find_optional(function2level, callee)) {
+                    level = std::max(level, *calleeLevel + 1);
+                }
+            }
+        }
+
+        foreach (const Function *function, component) {
+            function2level[function] = level;
+        }
+
+        if (levels_.size() <= level) {
+            levels_.resize(level + 1);
+        }
+        levels_[level].push_back(&component);
+    }
+}
+
+} // namespace misc
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,120 @@
+/* * SmartDec decompiler - SmartDec is a native code to C/C++ decompiler
+ * Copyright (C) 2015 Alexander Chernov, Katerina Troshina, Yegor Derevenets,
+ * Alexander Fokin, Sergey Levin, Leonid Tsvetkov
+ *
+ * This file is part of SmartDec decompiler.
+ *
+ * SmartDec decompiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SmartDec decompiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SmartDec decompiler.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class Function;
+class Functions;
+
+namespace calls {
+    class CallsData;
+}
+
+namespace misc {
+
+/**
+ * Call graph of a set of functions, split into strongly connected components.
+ *
+ * A function calls another one if it contains a call to the latter's entry address.
+ * The called address is taken from the calls data, if it is known there,
+ * or from the call's target, if the latter is a constant.
+ */
+class CallGraph {
+    public:
+
+    /** Strongly connected component: a set of mutually recursive functions. */
+    typedef std::vector<const Function *> Component;
+
+    private:
+
+    /** Mapping from a function to the functions called by it. */
+    boost::unordered_map<const Function *, std::vector<const Function *>> callees_;
+
+    /** Strongly connected components, callees going before callers. */
+    std::vector<Component> components_;
+
+    /**
+     * Strongly connected components grouped into levels.
+     * Components of a level only call functions from the same component
+     * or from components of the previous levels.
+     */
+    std::vector<std::vector<const Component *>> levels_;
+
+    public:
+
+    /**
+     * Constructor.
+     *
+     * \param functions Valid pointer to the functions.
+     * \param callsData Pointer to the calls data. Can be NULL.
+     */
+    CallGraph(const Functions *functions, const calls::CallsData *callsData);
+
+    /**
+     * \param function Valid pointer to a function.
+     *
+     * \return Functions called by the given function, in the order of first call.
+     */
+    const std::vector<const Function *> &getCallees(const Function *function) const;
+
+    /**
+     * \return Strongly connected components of the call graph in bottom-up order:
+     *         each component goes after all the components it calls.
+     */
+    const std::vector<Component> &components() const { return components_; }
+
+    /**
+     * \return Strongly connected components grouped into levels in bottom-up order.
+     *         Components of the same level do not call each other and, therefore,
+     *         can be processed independently, once the previous levels are done.
+     */
+    const std::vector<std::vector<const Component *>> &levels() const { return levels_; }
+
+    private:
+
+    /**
+     * Computes strongly connected components of the graph using Tarjan's algorithm.
+     *
+     * \param functions Valid pointer to the functions.
+     */
+    void computeComponents(const Functions *functions);
+
+    /**
+     * Groups the computed components into levels.
+     */
+    void computeLevels();
+};
+
+} // namespace misc
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
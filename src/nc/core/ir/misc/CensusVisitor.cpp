@@ -69,7 +69,7 @@ void CensusVisitor::operator()(const Statement *statement) {
     if (callsData()) {
         switch (statement->kind()) {
             case Statement::CALL:
-                if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(statement->asCall())) {
+                if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(currentFunction_, statement->asCall())) {
                     callAnalyzer->visitChildStatements(*this);
                     callAnalyzer->visitChildTerms(*this);
                 }
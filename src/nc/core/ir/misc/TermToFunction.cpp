@@ -42,11 +42,26 @@ TermToFunction::TermToFunction(const Functions *functions, calls::CallsData *cal
         visitor(function);
 
         foreach (const ir::Term *term, visitor.terms()) {
-            term2function_[term] = function;
+            std::vector<const Function *> &owners = term2functions_[term];
+            if (owners.empty() || owners.back() != function) {
+                owners.push_back(function);
+            }
         }
     }
 }
 
+const std::vector<const Function *> &TermToFunction::getFunctions(const Term *term) const {
+    assert(term != NULL);
+
+    auto i = term2functions_.find(term);
+    if (i != term2functions_.end()) {
+        return i->second;
+    }
+
+    static const std::vector<const Function *> empty;
+    return empty;
+}
+
 } // namespace misc
 } // namespace ir
 } // namespace core
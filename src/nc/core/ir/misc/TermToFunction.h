@@ -22,9 +22,9 @@
 
 #include <nc/config.h>
 
-#include <boost/unordered_map.hpp>
+#include <vector>
 
-#include <nc/common/Range.h> /* nc::find */
+#include <boost/unordered_map.hpp>
 
 namespace nc {
 namespace core {
@@ -45,7 +45,7 @@ namespace misc {
  */
 class TermToFunction {
     /** Mapping from terms to functions owning them. */
-    boost::unordered_map<const Term *, const Function *> term2function_;
+    boost::unordered_map<const Term *, std::vector<const Function *> > term2functions_;
 
     public:
 
@@ -59,9 +59,12 @@ class TermToFunction {
 
     /**
      * \param term Valid pointer to a term.
-     * \return Function owning the term.
+     *
+     * \return Functions owning the term, in the order of Functions::functions().
+     *         There are several of them if the term is in a basic block shared
+     *         by several functions.
      */
-    const Function *getFunction(const Term *term) const { return nc::find(term2function_, term); }
+    const std::vector<const Function *> &getFunctions(const Term *term) const;
 };
 
 } // namespace misc
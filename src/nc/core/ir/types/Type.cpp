@@ -35,34 +35,34 @@ namespace types {
 void Type::updateSize(SmallBitSize size) {
     if (size && (!size_ || size < size_)) {
         size_ = size;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makeInteger() {
     if (!isInteger_) {
         isInteger_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makeFloat() {
     if (!isFloat_) {
         isFloat_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makePointer(Type *pointee) {
     if (!isPointer_) {
         isPointer_ = true;
-        changed_ = true;
+        setChanged();
     }
 
     if (pointee) {
         if (!pointee_) {
             pointee_ = pointee;
-            changed_ = true;
+            setChanged();
         } else {
             pointee_->unionSet(pointee);
         }
@@ -72,14 +72,14 @@ void Type::makePointer(Type *pointee) {
 void Type::makeSigned() {
     if (!isSigned_) {
         isSigned_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makeUnsigned() {
     if (!isUnsigned_) {
         isUnsigned_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
@@ -102,7 +102,7 @@ void Type::updateFactor(ConstantValue increment) {
     factor_ = gcd(increment, factor_);
 
     if (oldFactor != factor_) {
-        changed_ = true;
+        setChanged();
     }
 }
 
@@ -117,6 +117,15 @@ void Type::addOffset(ByteOffset offset, Type *typeTraits) {
 }
 #endif
 
+void Type::setChanged() {
+    if (!changed_) {
+        changed_ = true;
+        if (changeLog_) {
+            changeLog_->push_back(this);
+        }
+    }
+}
+
 bool Type::changed() {
     if (changed_) {
         changed_ = false;
@@ -132,9 +141,15 @@ void Type::unionSet(Type *that) {
 
     DisjointSet<Type>::unionSet(that);
 
+    if (thisSet == thatSet) {
+        return;
+    }
+
     if (findSet() == thisSet) {
+        thatSet->setChanged();
         thisSet->join(thatSet);
     } else {
+        thisSet->setChanged();
         thatSet->join(thisSet);
     }
 }
@@ -22,6 +22,8 @@
 
 #include <nc/config.h>
 
+#include <vector>
+
 #ifdef NC_STRUCT_RECOVERY
 #include <map>
 #endif
@@ -59,16 +61,21 @@ class Type: public DisjointSet<Type>, public PrintableBase<Type> {
 #endif
 
     bool changed_; ///< Type properties have changed since last call to changed().
+    std::vector<Type *> *changeLog_; ///< Log of changed types to append this type to when it changes. Can be NULL.
 
     public:
 
     /**
      * Class constructor.
+     *
+     * \param[in] changeLog Pointer to the log to append this type to each time
+     *                      its changed flag gets set. Can be NULL.
      */
-    Type():
+    explicit Type(std::vector<Type *> *changeLog = NULL):
         size_(0),
         isInteger_(false), isFloat_(false), isPointer_(false), pointee_(0),
-        isSigned_(false), isUnsigned_(false), factor_(0), changed_(false)
+        isSigned_(false), isUnsigned_(false), factor_(0), changed_(false),
+        changeLog_(changeLog)
     { 
 #ifdef NC_STRUCT_RECOVERY
         addOffset(0, this); 
@@ -178,11 +185,13 @@ class Type: public DisjointSet<Type>, public PrintableBase<Type> {
 
     /**
      * \return True, if type properties have changed since last call to this function.
+     *         A type merged into another one is considered changed.
      */
     bool changed();
 
     /**
      * Merges this and that types together.
+     * The representative of the two sets that stops being one is marked as changed.
      *
      * \param[in] that Type traits to merge with.
      */
@@ -201,6 +210,13 @@ class Type: public DisjointSet<Type>, public PrintableBase<Type> {
      * \param out Output stream.
      */
     void print(QTextStream &out) const;
+
+    private:
+
+    /**
+     * Sets the changed flag and, if it was not set, appends this type to the change log.
+     */
+    void setChanged();
 };
 
 } // namespace types
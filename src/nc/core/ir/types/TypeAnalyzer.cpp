@@ -21,9 +21,15 @@
 
 #include "TypeAnalyzer.h"
 
+#include <deque>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
 #include <nc/common/CancellationToken.h>
 #include <nc/common/Foreach.h>
 #include <nc/common/Unreachable.h>
+#include <nc/common/Visitor.h>
 #include <nc/common/Warnings.h>
 
 #include <nc/core/ir/Function.h>
@@ -86,28 +92,101 @@ void TypeAnalyzer::analyze(const Function *function, const CancellationToken &ca
     terms.erase(std::remove_if(terms.begin(), terms.end(),
         [this](const Term *term) { return !this->usage().isUsed(term); }), terms.end());
 
-    bool changed;
-    do {
-        foreach (const Term *term, terms) {
-            analyze(term);
-        }
-        reverse_foreach (const Term *term, terms) {
-            analyze(term);
+    const std::vector<const Statement *> &statements = census.statements();
+
+    /*
+     * Rules are numbered as follows: first go the used terms, then the statements.
+     * Each rule depends on the types of the terms it reads or modifies.
+     */
+    std::size_t ruleCount = terms.size() + statements.size();
+
+    /* Mapping from a set representative to the rules depending on the types in the set. */
+    boost::unordered_map<const Type *, std::vector<std::size_t> > dependentRules;
+
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        dependentRules[types().getType(terms[i])].push_back(i);
+
+        auto visitor = makeVisitor<const Term>([&](const Term *child) {
+            dependentRules[types().getType(child)].push_back(i);
+        });
+        terms[i]->visitChildTerms(visitor);
+    }
+
+    for (std::size_t i = 0; i < statements.size(); ++i) {
+        if (const Assignment *assignment = statements[i]->asAssignment()) {
+            dependentRules[types().getType(assignment->left())].push_back(terms.size() + i);
+            dependentRules[types().getType(assignment->right())].push_back(terms.size() + i);
         }
-        foreach (const Statement *statement, census.statements()) {
-            analyze(statement);
+    }
+
+    /* Everything is going to be analyzed anyway, so forget the changes done so far. */
+    std::vector<Type *> &changedTypes = types().changedTypes();
+    foreach (Type *type, changedTypes) {
+        type->changed();
+    }
+    changedTypes.clear();
+
+    /*
+     * Worklist of rules to (re)evaluate, initially containing all of them.
+     * A rule is put back into it only when the type of a term it depends on changes.
+     */
+    std::deque<std::size_t> worklist;
+    std::vector<bool> enqueued(ruleCount, true);
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        worklist.push_back(i);
+    }
+
+    auto enqueue = [&](const std::vector<std::size_t> &rules) {
+        foreach (std::size_t rule, rules) {
+            if (!enqueued[rule]) {
+                enqueued[rule] = true;
+                worklist.push_back(rule);
+            }
         }
-        reverse_foreach (const Statement *statement, census.statements()) {
-            analyze(statement);
+    };
+
+    while (!worklist.empty() && !canceled) {
+        std::size_t rule = worklist.front();
+        worklist.pop_front();
+        enqueued[rule] = false;
+
+        if (rule < terms.size()) {
+            analyze(terms[rule]);
+        } else {
+            analyze(statements[rule - terms.size()]);
         }
 
-        changed = false;
-        foreach (auto &item, types().types()) {
-            if (item.second->changed()) {
-                changed = true;
+        /*
+         * A changed representative affects all the rules depending on its set.
+         * A type that has stopped being a representative has been merged into
+         * another set: the rules depending on it see new traits (or new equalities
+         * between types), and its dependents move to the new representative.
+         * The new representative is in the log itself if its own traits have changed.
+         */
+        for (std::size_t i = 0; i < changedTypes.size(); ++i) {
+            Type *type = changedTypes[i];
+            type->changed();
+
+            auto it = dependentRules.find(type);
+            if (it == dependentRules.end()) {
+                continue;
+            }
+
+            std::vector<std::size_t> &rules = it->second;
+            enqueue(rules);
+
+            Type *representative = type->findSet();
+            if (representative != type) {
+                std::vector<std::size_t> &representativeRules = dependentRules[representative];
+                if (representativeRules.size() < rules.size()) {
+                    representativeRules.swap(rules);
+                }
+                representativeRules.insert(representativeRules.end(), rules.begin(), rules.end());
+                dependentRules.erase(type);
             }
         }
-    } while (changed && !canceled);
+        changedTypes.clear();
+    }
 }
 
 void TypeAnalyzer::analyze(const Term *term) {
@@ -35,13 +35,14 @@ Types::Types() {}
 Types::~Types() {}
 
 Type *Types::getType(const Term *term) {
-    auto &type = types_[term];
-    if (!type) {
-        type.reset(new Type());
+    auto result = index_.insert(term);
+    if (result.second) {
+        storage_.emplace_back(&changedTypes_);
+        Type *type = &storage_.back();
         type->updateSize(term->size());
-        return type.get();
+        return type;
     } else {
-        return type->findSet();
+        return storage_[result.first].findSet();
     }
 }
 
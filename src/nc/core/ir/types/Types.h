@@ -20,7 +20,12 @@
 
 #pragma once
 
-#include <boost/unordered_map.hpp>
+#include <deque>
+#include <vector>
+
+#include <nc/core/ir/TermIndex.h>
+
+#include "Type.h"
 
 namespace nc {
 namespace core {
@@ -30,13 +35,13 @@ class Term;
 
 namespace types {
 
-class Type;
-
 /**
  * Information about computed type traits.
  */
 class Types {
-    mutable boost::unordered_map<const Term *, std::unique_ptr<Type> > types_; ///< Mapping of terms to their type traits.
+    TermIndex index_; ///< Numbers of the terms, indices in storage_.
+    std::deque<Type> storage_; ///< Type traits of the terms, indexed by their numbers.
+    std::vector<Type *> changedTypes_; ///< Types whose changed flag got set since it was last reset.
 
     public:
 
@@ -65,9 +70,14 @@ class Types {
     const Type *getType(const Term *term) const;
 
     /**
-     * \return Mapping of terms to their type traits.
+     * Types owned by this object append themselves to this log when their
+     * changed flag gets set, i.e. at most once between two calls to
+     * Type::changed() returning true. Entries are not necessarily
+     * representatives of their sets.
+     *
+     * \return Log of changed types.
      */
-    boost::unordered_map<const Term *, std::unique_ptr<Type> > &types() { return types_; };
+    std::vector<Type *> &changedTypes() { return changedTypes_; }
 };
 
 }}}} // namespace nc::core::ir::types
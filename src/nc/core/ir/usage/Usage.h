@@ -22,7 +22,9 @@
 
 #include <nc/config.h>
 
-#include <boost/unordered_set.hpp>
+#include <vector>
+
+#include <nc/core/ir/TermIndex.h>
 
 namespace nc {
 namespace core {
@@ -36,7 +38,8 @@ namespace usage {
  * Set of terms producing actual high-level code.
  */
 class Usage {
-    boost::unordered_set<const Term *> usedTerms_; ///< Set of used terms.
+    TermIndex index_; ///< Numbers of the terms ever marked as used.
+    std::vector<bool> used_; ///< Flags telling whether the terms are used, indexed by their numbers.
 
     public:
 
@@ -45,21 +48,36 @@ class Usage {
      *
      * \return True if term is used.
      */
-    bool isUsed(const Term *term) const { return usedTerms_.find(term) != usedTerms_.end(); }
+    bool isUsed(const Term *term) const {
+        std::size_t number = index_.find(term);
+        return number != TermIndex::NOT_FOUND && used_[number];
+    }
 
     /**
      * Marks a term as used.
      *
      * \param[in] term Term.
      */
-    void makeUsed(const Term *term) { usedTerms_.insert(term); }
+    void makeUsed(const Term *term) {
+        auto result = index_.insert(term);
+        if (result.second) {
+            used_.push_back(true);
+        } else {
+            used_[result.first] = true;
+        }
+    }
 
     /**
      * Marks a term as unused.
      *
      * \param[in] term Term.
      */
-    void makeUnused(const Term *term) { usedTerms_.erase(term); }
+    void makeUnused(const Term *term) {
+        std::size_t number = index_.find(term);
+        if (number != TermIndex::NOT_FOUND) {
+            used_[number] = false;
+        }
+    }
 };
 
 } // namespace usage
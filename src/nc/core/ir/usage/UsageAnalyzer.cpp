@@ -136,8 +136,8 @@ void UsageAnalyzer::computeUsage(const Statement *statement) {
             makeUsed(call->target());
 
             if (callsData()) {
-                if (const calls::FunctionSignature *signature = callsData()->getFunctionSignature(call)) {
-                    if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(call)) {
+                if (const calls::FunctionSignature *signature = callsData()->getFunctionSignature(function(), call)) {
+                    if (calls::CallAnalyzer *callAnalyzer = callsData()->getCallAnalyzer(function(), call)) {
                         foreach (const MemoryLocation &memoryLocation, signature->arguments()) {
                             makeUsed(callAnalyzer->getArgumentTerm(memoryLocation));
                         }
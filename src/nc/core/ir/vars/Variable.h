@@ -22,20 +22,21 @@
 
 #include <nc/config.h>
 
-#include <nc/common/DisjointSet.h>
+#include <cstddef> /* std::size_t */
 
 namespace nc {
 namespace core {
 namespace ir {
 namespace vars {
 
-class Variable;
-
 /**
- * Variable is a unique object associated with a set of terms representing
- * the same variable of reconstructed program.
+ * Identifier of a variable of reconstructed program, i.e. of a set of
+ * terms representing the same variable.
+ *
+ * Sets of terms are maintained by Variables. Identifiers are only
+ * meaningful within the Variables object that issued them.
  */
-class Variable: public DisjointSet<Variable> {};
+typedef std::size_t VariableId;
 
 } // namespace vars
 } // namespace ir
@@ -40,11 +40,9 @@ void VariableAnalyzer::analyze(const Function *function) {
 
     foreach (const Term *term, census.terms()) {
         if (term->isRead()) {
-            Variable *variable = variables().getVariable(term);
-            
             foreach (const Term *definition, dataflow().getDefinitions(term)) {
                 assert(dataflow().getMemoryLocation(term) == dataflow().getMemoryLocation(definition));
-                variable->unionSet(variables().getVariable(definition));
+                variables().unionSet(term, definition);
             }
         }
     }
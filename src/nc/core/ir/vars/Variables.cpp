@@ -26,18 +26,21 @@ namespace core {
 namespace ir {
 namespace vars {
 
-Variable *Variables::getVariable(const Term *term) {
-    auto &variable = variables_[term];
-    if (!variable) {
-        variable.reset(new Variable);
-        return variable.get();
-    } else {
-        return variable->findSet();
+std::size_t Variables::getIndex(const Term *term) const {
+    auto result = index_.insert(term);
+    if (result.second) {
+        /* Terms and sets are numbered in the same order. */
+        sets_.add();
     }
+    return result.first;
 }
 
-const Variable *Variables::getVariable(const Term *term) const {
-    return const_cast<Variables *>(this)->getVariable(term);
+VariableId Variables::getVariable(const Term *term) const {
+    return sets_.find(getIndex(term));
+}
+
+void Variables::unionSet(const Term *a, const Term *b) {
+    sets_.unite(getIndex(a), getIndex(b));
 }
 
 } // namespace vars
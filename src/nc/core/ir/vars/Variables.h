@@ -22,9 +22,9 @@
 
 #include <nc/config.h>
 
-#include <memory> /* unique_ptr */
+#include <nc/common/UnionFind.h>
 
-#include <boost/unordered_map.hpp>
+#include <nc/core/ir/TermIndex.h>
 
 #include "Variable.h"
 
@@ -40,23 +40,36 @@ namespace vars {
  * Container for information about which term realizes which variable of reconstructed program.
  */
 class Variables {
-    mutable boost::unordered_map<const Term *, std::unique_ptr<Variable> > variables_; ///< Mapping of terms to variables.
+    mutable TermIndex index_; ///< Numbers of the terms, elements of sets_.
+    mutable UnionFind sets_; ///< Sets of numbers of terms representing the same variable.
 
     public:
 
     /**
      * \param[in] term Term.
      *
-     * \return Variable represented by this term.
+     * \return Identifier of the variable represented by this term.
+     *         Terms representing the same variable get the same identifier.
+     *         Identifiers returned before a unionSet() call can become stale.
      */
-    Variable *getVariable(const Term *term);
+    VariableId getVariable(const Term *term) const;
+
+    /**
+     * Merges the variables represented by the given terms.
+     *
+     * \param[in] a Term.
+     * \param[in] b Term.
+     */
+    void unionSet(const Term *a, const Term *b);
+
+    private:
 
     /**
      * \param[in] term Term.
      *
-     * \return Variable represented by this term.
+     * \return Number of the term, allocated on first request.
      */
-    const Variable *getVariable(const Term *term) const;
+    std::size_t getIndex(const Term *term) const;
 };
 
 } // namespace vars
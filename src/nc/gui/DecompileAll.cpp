@@ -48,6 +48,7 @@ void DecompileAll::work() {
     context->setInstructions(project_->instructions());
     context->setCancellationToken(cancellationToken());
     context->setLogToken(project_->logToken());
+    context->setThreadCount(project_->threadCount());
 
     project_->setContext(context);
 
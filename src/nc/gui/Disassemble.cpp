@@ -46,6 +46,7 @@ void Disassemble::work() {
     auto context = std::make_shared<core::Context>();
     context->setModule(project_->module());
     context->setInstructions(project_->instructions());
+    context->setThreadCount(project_->threadCount());
     context->setCancellationToken(cancellationToken());
     context->setLogToken(project_->logToken());
 
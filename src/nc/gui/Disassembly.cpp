@@ -39,15 +39,27 @@ Disassembly::Disassembly(const std::shared_ptr<core::Context> &context, const co
     assert(source);
 }
 
+Disassembly::Disassembly(const std::shared_ptr<core::Context> &context):
+    context_(context), source_(NULL), begin_(0), end_(0)
+{
+    assert(context);
+}
+
 Disassembly::~Disassembly() {}
 
 void Disassembly::work() {
-    auto newInstructions = std::make_shared<core::arch::Instructions>(*context_->instructions());
+    if (!source_) {
+        if (!context_->disassembleRecursively()) {
+            context_->disassemble();
+        }
+    } else {
+        auto newInstructions = std::make_shared<core::arch::Instructions>(*context_->instructions());
 
-    core::arch::disasm::Disassembler disassembler(context_->module()->architecture(), newInstructions.get());
-    disassembler.disassemble(source_, begin_, end_, context_->cancellationToken());
+        core::arch::disasm::Disassembler disassembler(context_->module()->architecture(), newInstructions.get());
+        disassembler.disassemble(source_, begin_, end_, context_->cancellationToken());
 
-    context_->setInstructions(newInstructions);
+        context_->setInstructions(newInstructions);
+    }
 
     if (context_->cancellationToken().cancellationRequested()) {
         context_->logToken() << tr("Disassembly canceled.");
@@ -49,7 +49,7 @@ class Disassembly: public Activity {
     /** Context. */
     std::shared_ptr<core::Context> context_;
 
-    /** What to disassemble. */
+    /** What to disassemble, or NULL to disassemble recursively from the entry points. */
     const core::image::ByteSource *source_;
 
     /** First address in the range to be disassembled. */
@@ -70,6 +70,14 @@ class Disassembly: public Activity {
      */
     Disassembly(const std::shared_ptr<core::Context> &context, const core::image::ByteSource *source, ByteAddr begin, ByteAddr end);
 
+    /**
+     * Constructor of an activity disassembling the code reachable from
+     * the entry point and the named addresses of the module.
+     *
+     * \param context Valid pointer to the context.
+     */
+    explicit Disassembly(const std::shared_ptr<core::Context> &context);
+
     /**
      * Destructor.
      */
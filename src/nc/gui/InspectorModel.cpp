@@ -25,6 +25,7 @@
 
 #include <nc/core/Context.h>
 #include <nc/core/arch/Instruction.h>
+#include <nc/core/ir/Function.h>
 #include <nc/core/ir/Jump.h>
 #include <nc/core/ir/Statements.h>
 #include <nc/core/ir/Terms.h>
@@ -175,11 +176,19 @@ void expand(InspectorItem *item, const core::ir::Term *term, const core::Context
     }
     item->addChild(tr("size = %1").arg(term->size()));
 
-    if (const core::ir::Function *function = context->termToFunction()->getFunction(term)) {
+    const auto &functions = context->termToFunction()->getFunctions(term);
+    if (functions.empty()) {
+        item->addChild("function = NULL");
+    }
+
+    /* A term in a basic block shared by several functions has dataflow information in each of them. */
+    foreach (const core::ir::Function *function, functions) {
+        InspectorItem *functionItem = functions.size() == 1 ? item : item->addChild(tr("in function %1").arg(function->name()));
+
         auto dataflow = context->getDataflow(function);
 
         if (const core::ir::dflow::Value *value = dataflow->getValue(term)) {
-            InspectorItem *valueItem = item->addChild(tr("value properties"));
+            InspectorItem *valueItem = functionItem->addChild(tr("value properties"));
             if (value->isConstant()) {
                 valueItem->addChild(tr("constant value = %1").arg(value->constantValue().value()));
             } else {
@@ -198,20 +207,18 @@ void expand(InspectorItem *item, const core::ir::Term *term, const core::Context
         }
 
         if (term->isRead()) {
-            InspectorItem *definitionsItem = item->addChild(tr("definitions"));
+            InspectorItem *definitionsItem = functionItem->addChild(tr("definitions"));
             foreach (const core::ir::Term *definition, dataflow->getDefinitions(term)) {
                 definitionsItem->addChild("", definition);
             }
         }
 
         if (term->isWrite()) {
-            InspectorItem *usesItem = item->addChild(tr("uses"));
+            InspectorItem *usesItem = functionItem->addChild(tr("uses"));
             foreach (const core::ir::Term *use, dataflow->getUses(term)) {
                 usesItem->addChild("", use);
             }
         }
-    } else {
-        item->addChild("function = NULL");
     }
 
     switch (term->kind()) {
@@ -21,10 +21,13 @@
 
 #include "MainWindow.h"
 
+#include <algorithm> /* std::max() */
+
 #include <QAction>
 #include <QApplication>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QInputDialog>
 #include <QLabel>
 #include <QMenu>
 #include <QMenuBar>
@@ -34,6 +37,7 @@
 #include <QSettings>
 #include <QStatusBar>
 #include <QTextStream>
+#include <QThread>
 #include <QTreeView>
 
 #include <nc/common/Exception.h>
@@ -65,7 +69,8 @@
 namespace nc { namespace gui {
 
 MainWindow::MainWindow(QWidget *parent):
-    QMainWindow(parent)
+    QMainWindow(parent),
+    threadCount_(1)
 {
     setDockNestingEnabled(true);
     setTabPosition(Qt::AllDockWidgetAreas, QTabWidget::North);
@@ -184,6 +189,16 @@ void MainWindow::createActions() {
     decompileAutomaticallyAction_->setCheckable(true);
     connect(decompileAutomaticallyAction_, SIGNAL(toggled(bool)), this, SLOT(setDecompileAutomatically(bool)));
 
+    disassembleRecursivelyAction_ = new QAction(tr("Disassemble &Recursively"), this);
+    disassembleRecursivelyAction_->setCheckable(true);
+    connect(disassembleRecursivelyAction_, SIGNAL(toggled(bool)), this, SLOT(setDisassembleRecursively(bool)));
+
+    threadCountAction_ = new QAction(tr("&Threads..."), this);
+    connect(threadCountAction_, SIGNAL(triggered()), this, SLOT(chooseThreadCount()));
+#ifndef NC_USE_THREADS
+    threadCountAction_->setVisible(false);
+#endif
+
     instructionsViewAction_ = instructionsView_->toggleViewAction();
     instructionsViewAction_->setText(tr("&Instructions"));
     instructionsViewAction_->setShortcut(Qt::ALT + Qt::Key_I);
@@ -229,9 +244,11 @@ void MainWindow::createMenus() {
 
     QMenu *analyseMenu = menuBar()->addMenu(tr("&Analyse"));
     analyseMenu->addAction(disassembleAction_);
+    analyseMenu->addAction(disassembleRecursivelyAction_);
     analyseMenu->addSeparator();
     analyseMenu->addAction(decompileAction_);
     analyseMenu->addAction(decompileAutomaticallyAction_);
+    analyseMenu->addAction(threadCountAction_);
     analyseMenu->addSeparator();
     analyseMenu->addAction(cancelAllAction_);
 
@@ -257,6 +274,10 @@ void MainWindow::loadSettings() {
     }
     restoreState(settings_->value("windowState").toByteArray());
     setDecompileAutomatically(settings_->value("decompileAutomatically", true).toBool());
+    setDisassembleRecursively(settings_->value("disassembleRecursively", false).toBool());
+#ifdef NC_USE_THREADS
+    setThreadCount(std::max(settings_->value("threadCount", QThread::idealThreadCount()).toInt(), 1));
+#endif
 }
 
 void MainWindow::saveSettings() {
@@ -265,6 +286,10 @@ void MainWindow::saveSettings() {
     }
     settings_->setValue("windowState", saveState());
     settings_->setValue("decompileAutomatically", decompileAutomatically());
+    settings_->setValue("disassembleRecursively", disassembleRecursively());
+#ifdef NC_USE_THREADS
+    settings_->setValue("threadCount", threadCount());
+#endif
 }
 
 void MainWindow::updateGuiState() {
@@ -334,7 +359,11 @@ void MainWindow::open(const QStringList &filenames) {
     open(std::move(project));
 
     if (project_->instructions()->empty()) {
-        project_->disassemble();
+        if (disassembleRecursively()) {
+            project_->disassembleRecursively();
+        } else {
+            project_->disassemble();
+        }
     }
 
     if (decompileAutomatically()) {
@@ -346,6 +375,7 @@ void MainWindow::open(std::unique_ptr<Project> project) {
     assert(project);
 
     project_ = std::move(project);
+    project_->setThreadCount(threadCount());
 
     sectionsView_->model()->setModule();
     disassemblyDialog_->setModule();
@@ -504,6 +534,32 @@ void MainWindow::setDecompileAutomatically(bool value) {
     decompileAutomaticallyAction_->setChecked(value);
 }
 
+bool MainWindow::disassembleRecursively() const {
+    return disassembleRecursivelyAction_->isChecked();
+}
+
+void MainWindow::setDisassembleRecursively(bool value) {
+    disassembleRecursivelyAction_->setChecked(value);
+}
+
+void MainWindow::setThreadCount(int count) {
+    assert(count > 0);
+
+    threadCount_ = count;
+    if (project()) {
+        project()->setThreadCount(count);
+    }
+}
+
+void MainWindow::chooseThreadCount() {
+    bool ok;
+    int count = QInputDialog::getInt(this, tr("Threads"), tr("Maximal number of threads used for analyses:"),
+                                     threadCount(), 1, 1024, 1, &ok);
+    if (ok) {
+        setThreadCount(count);
+    }
+}
+
 void MainWindow::highlightInstructionsInCxx() {
     if (cxxView_->isVisible()) {
         /* Block signals, in order to avoid backfire. */
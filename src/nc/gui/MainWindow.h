@@ -76,6 +76,8 @@ class MainWindow: public QMainWindow {
     QAction *decompileAction_; ///< Action for starting decompilation.
     QAction *cancelAllAction_; ///< Action for cancelling all scheduled commands.
     QAction *decompileAutomaticallyAction_; ///< Action for toggling automatic decompilation.
+    QAction *disassembleRecursivelyAction_; ///< Action for toggling recursive disassembly of opened files.
+    QAction *threadCountAction_; ///< Action for setting the number of analysis threads.
     QAction *instructionsViewAction_; ///< Action for showing/hiding the instructions window.
     QAction *sectionsViewAction_; ///< Action for showing/hiding the sections' window.
     QAction *inspectorViewAction_; ///< Action for showing/hiding the tree inspector.
@@ -87,6 +89,8 @@ class MainWindow: public QMainWindow {
 
     QSettings *settings_; ///< Application settings.
 
+    int threadCount_; ///< Maximal number of threads used for analyses.
+
     std::unique_ptr<Project> project_; ///< Current project.
 
     LogToken logToken_; ///< Log token.
@@ -136,6 +140,18 @@ class MainWindow: public QMainWindow {
      */
     bool decompileAutomatically() const;
 
+    /**
+     * \return True if opened files must be disassembled recursively from
+     *         the entry point and the named addresses, false if all code
+     *         sections must be disassembled.
+     */
+    bool disassembleRecursively() const;
+
+    /**
+     * \return Maximal number of threads used for analyses.
+     */
+    int threadCount() const { return threadCount_; }
+
     public Q_SLOTS:
 
     /**
@@ -145,6 +161,21 @@ class MainWindow: public QMainWindow {
      */
     void setDecompileAutomatically(bool value);
 
+    /**
+     * Sets whether opened files must be disassembled recursively.
+     *
+     * \param value True to disassemble recursively, false to disassemble all code sections.
+     */
+    void setDisassembleRecursively(bool value);
+
+    /**
+     * Sets the maximal number of threads used for analyses.
+     * The setting is applied to the current project and to the projects opened later.
+     *
+     * \param count Number of threads, must be positive.
+     */
+    void setThreadCount(int count);
+
     /**
      * Opens a dialog for selecting files for decompilation, parses selected files, and starts decompiling them.
      */
@@ -313,6 +344,11 @@ class MainWindow: public QMainWindow {
      */
     void decompileSelectedInstructions();
 
+    /**
+     * Asks the user for the maximal number of threads used for analyses.
+     */
+    void chooseThreadCount();
+
     /**
      * Highlights code produced by selected assembler instructions in C++ view.
      */
@@ -21,8 +21,13 @@
 
 #include "Project.h"
 
+#include <algorithm> /* std::max */
 #include <cassert>
 
+#ifdef NC_USE_THREADS
+#include <QThread>
+#endif
+
 #include <nc/common/make_unique.h>
 #include <nc/common/Foreach.h>
 
@@ -36,6 +41,7 @@
 #include "DecompileAll.h"
 #include "DeleteInstructions.h"
 #include "Disassemble.h"
+#include "DisassembleRecursively.h"
 
 namespace nc {
 namespace gui {
@@ -45,8 +51,12 @@ Project::Project(QObject *parent):
     module_(std::make_shared<core::Module>()),
     instructions_(std::make_shared<const core::arch::Instructions>()),
     context_(std::make_shared<core::Context>()),
+    threadCount_(1),
     commandQueue_(new CommandQueue(this))
 {
+#ifdef NC_USE_THREADS
+    threadCount_ = std::max(QThread::idealThreadCount(), 1);
+#endif
 }
 
 Project::~Project() {}
@@ -110,6 +120,10 @@ void Project::disassemble(const core::image::ByteSource *source, ByteAddr begin,
     commandQueue()->push(std::make_unique<Disassemble>(this, source, begin, end));
 }
 
+void Project::disassembleRecursively() {
+    commandQueue()->push(std::make_unique<DisassembleRecursively>(this));
+}
+
 void Project::decompile() {
     commandQueue()->push(std::make_unique<DecompileAll>(this));
 }
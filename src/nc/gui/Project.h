@@ -73,6 +73,9 @@ class Project: public QObject {
     /** Log token. */
     LogToken logToken_;
 
+    /** Maximal number of threads used for per-function analyses. */
+    int threadCount_;
+
     /** Queue of user commands. */
     CommandQueue *commandQueue_;
 
@@ -150,6 +153,18 @@ class Project: public QObject {
      */
     const LogToken &logToken() const { return logToken_; }
 
+    /**
+     * Sets the maximal number of threads used for per-function analyses.
+     *
+     * \param count Number of threads, must be positive.
+     */
+    void setThreadCount(int count) { assert(count > 0); threadCount_ = count; }
+
+    /**
+     * \return Maximal number of threads used for per-function analyses.
+     */
+    int threadCount() const { return threadCount_; }
+
     /*
      * \return Valid pointer to command queue.
      */
@@ -192,6 +207,13 @@ class Project: public QObject {
      */
     void disassemble();
 
+    /**
+     * Schedules disassembly of the code reachable from the entry point
+     * and the named addresses. Falls back to disassembling all code
+     * sections when there are none.
+     */
+    void disassembleRecursively();
+
     /**
      * Schedules decompilation of all the instructions of the project.
      */
@@ -21,8 +21,15 @@
 
 #include "ElfParser.h"
 
+#include <cassert>
+#include <cstring> /* memchr() */
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+#include <QByteArray>
 #include <QCoreApplication> /* For Q_DECLARE_TR_FUNCTIONS. */
-#include <QIODevice>
+#include <QFile>
 
 #include <nc/common/Foreach.h>
 #include <nc/common/make_unique.h>
@@ -30,6 +37,8 @@
 #include <nc/core/Module.h>
 #include <nc/core/image/Image.h>
 #include <nc/core/image/BufferByteSource.h>
+#include <nc/core/image/MappedFile.h>
+#include <nc/core/image/MappedFileByteSource.h>
 #include <nc/core/input/ParseError.h>
 
 #include "elf32.h"
@@ -41,17 +50,107 @@ namespace elf {
 
 namespace {
 
+/**
+ * View of an ELF string table resolving names in place.
+ */
+class StringTable {
+    const core::image::Section *section_; ///< Section containing the table.
+    QByteArray buffer_; ///< Copy of the table, if it is not available in contiguous memory.
+    const char *data_; ///< Contents of the table, or NULL if strings are read from the section one by one.
+    ByteSize size_; ///< Size of the table.
+
+    /** Maximal size of a table copied into a buffer. QByteArray cannot grow much bigger. */
+    static const ByteSize MAX_BUFFER_SIZE = 1 << 30;
+
+    public:
+
+    /**
+     * Constructor.
+     *
+     * \param section Valid pointer to the section containing the table.
+     */
+    explicit StringTable(const core::image::Section *section): section_(section), data_(NULL), size_(0) {
+        assert(section != NULL);
+
+        size_ = section->size();
+
+        ByteSize size;
+        if (const char *data = section->getBytes(section->addr(), &size)) {
+            if (size >= section->size()) {
+                data_ = data;
+                return;
+            }
+        }
+
+        if (size_ <= MAX_BUFFER_SIZE) {
+            buffer_.resize(static_cast<int>(size_));
+            size_ = section->readBytes(section->addr(), buffer_.data(), size_);
+            data_ = buffer_.constData();
+        }
+    }
+
+    /**
+     * \param offset Offset of a string in the table.
+     *
+     * \return The string at the given offset, or NULL string if the offset is out of range.
+     */
+    QString getString(ByteSize offset) const {
+        if (offset < 0 || offset >= size_) {
+            return QString();
+        }
+
+        /* Strings are limited in length, as QString cannot grow much bigger either. */
+        ByteSize maxSize = size_ - offset < MAX_BUFFER_SIZE ? size_ - offset : MAX_BUFFER_SIZE;
+
+        if (!data_) {
+            return section_->readAsciizString(section_->addr() + offset, maxSize);
+        }
+
+        const char *begin = data_ + offset;
+        const char *end = static_cast<const char *>(memchr(begin, '\0', maxSize));
+
+        return QString::fromLatin1(begin, static_cast<int>(end ? end - begin : maxSize));
+    }
+};
+
+/**
+ * Reads an array of structures from a section.
+ *
+ * \param section Valid pointer to the section.
+ *
+ * \return The structures fully contained in the section.
+ */
+template<class T>
+std::vector<T> readArray(const core::image::Section *section) {
+    assert(section != NULL);
+
+    std::vector<T> result(static_cast<std::size_t>(section->size() / sizeof(T)));
+    if (!result.empty()) {
+        ByteSize size = section->readBytes(section->addr(), &result[0], result.size() * sizeof(T));
+        result.resize(static_cast<std::size_t>(size / sizeof(T)));
+    }
+    return result;
+}
+
 class ElfParserPrivate {
     Q_DECLARE_TR_FUNCTIONS(ElfParserPrivate)
 
     QIODevice *source_;
     core::Module *module_;
+    std::shared_ptr<const core::image::MappedFile> mappedFile_;
 
     public:
 
     ElfParserPrivate(QIODevice *source, core::Module *module):
         source_(source), module_(module)
-    {}
+    {
+        if (QFile *file = qobject_cast<QFile *>(source)) {
+            auto mappedFile = std::make_shared<core::image::MappedFile>(file->fileName());
+            if (mappedFile->data()) {
+                mappedFile_ = mappedFile;
+            }
+        }
+    }
 
     void parse() {
         union {
@@ -69,14 +168,14 @@ class ElfParserPrivate {
                 if (bytesRead < sizeof(ehdr.ehdr32)) {
                     throw core::input::ParseError(tr("Cannot read ELF32 header."));
                 }
-                parseHeaders<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym>(ehdr.ehdr32);
+                parseHeaders<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym, Elf32_Rel, Elf32_Rela>(ehdr.ehdr32);
                 break;
             }
             case ELFCLASS64: {
                 if (bytesRead < sizeof(ehdr.ehdr64)) {
                     throw core::input::ParseError(tr("Cannot read ELF64 header."));
                 }
-                parseHeaders<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym>(ehdr.ehdr64);
+                parseHeaders<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym, Elf64_Rel, Elf64_Rela>(ehdr.ehdr64);
                 break;
             }
             default: {
@@ -87,7 +186,7 @@ class ElfParserPrivate {
 
     private:
 
-    template<class Ehdr, class Shdr, class Sym>
+    template<class Ehdr, class Shdr, class Sym, class Rel, class Rela>
     void parseHeaders(const Ehdr &ehdr) {
         switch (ehdr.e_machine) {
             case EM_386:
@@ -100,6 +199,10 @@ class ElfParserPrivate {
                 throw core::input::ParseError(tr("Unknown machine id: %1.").arg(ehdr.e_machine));
         }
 
+        if (ehdr.e_entry) {
+            module_->setEntryPoint(ehdr.e_entry);
+        }
+
         source_->seek(ehdr.e_shoff);
 
         std::vector<Shdr> shdrs(ehdr.e_shnum);
@@ -121,32 +224,213 @@ class ElfParserPrivate {
             section->setBss(shdr.sh_type == SHT_NOBITS);
             section->setData(section->isAllocated() && !section->isCode() && !section->isBss());
 
-            if (source_->seek(shdr.sh_offset)) {
+            if (section->isBss()) {
+                section->setExternalByteSource(std::make_unique<core::image::MappedFileByteSource>(mappedFile_, 0, 0, shdr.sh_size));
+            } else if (mappedFile_) {
+                section->setExternalByteSource(std::make_unique<core::image::MappedFileByteSource>(mappedFile_, shdr.sh_offset, shdr.sh_size, shdr.sh_size));
+            } else if (source_->seek(shdr.sh_offset)) {
                 section->setExternalByteSource(std::make_unique<core::image::BufferByteSource>(source_->read(shdr.sh_size)));
             }
         }
 
         if (ehdr.e_shstrndx < shdrs.size()) {
-            const core::image::Section *shstrtab = module_->image()->sections()[initialSectionsCount + ehdr.e_shstrndx];
+            StringTable shstrtab(module_->image()->sections()[initialSectionsCount + ehdr.e_shstrndx]);
 
             for (std::size_t i = 0; i < shdrs.size(); ++i) {
-                module_->image()->sections()[initialSectionsCount + i]->setName(
-                    shstrtab->readAsciizString(shdrs[i].sh_name, shstrtab->size()));
+                module_->image()->sections()[initialSectionsCount + i]->setName(shstrtab.getString(shdrs[i].sh_name));
             }
         }
 
         if (const core::image::Section *symtab = module_->image()->getSectionByName(".symtab")) {
             if (const core::image::Section *strtab = module_->image()->getSectionByName(".strtab")) {
-                Sym sym;
-                for (ByteAddr addr = symtab->addr(); addr < symtab->endAddr(); addr += sizeof(sym)) {
-                    if (symtab->readBytes(addr, &sym, sizeof(sym)) != sizeof(sym)) {
+                StringTable strings(strtab);
+
+                foreach (const Sym &sym, readArray<Sym>(symtab)) {
+                    module_->addName(sym.st_value, strings.getString(sym.st_name));
+                }
+            }
+        }
+
+        parseDynamicSymbols<Ehdr, Shdr, Sym, Rel, Rela>(ehdr, shdrs, initialSectionsCount);
+    }
+
+    /**
+     * Gives names to the dynamic symbols defined in the module, to the GOT slots
+     * of the imported symbols, and to the PLT stubs jumping through these slots.
+     */
+    template<class Ehdr, class Shdr, class Sym, class Rel, class Rela>
+    void parseDynamicSymbols(const Ehdr &ehdr, const std::vector<Shdr> &shdrs, std::size_t initialSectionsCount) {
+        const core::image::Section *dynsym = module_->image()->getSectionByName(".dynsym");
+        const core::image::Section *dynstr = module_->image()->getSectionByName(".dynstr");
+
+        if (!dynsym || !dynstr) {
+            return;
+        }
+
+        StringTable strings(dynstr);
+
+        std::vector<QString> symbolNames;
+        foreach (const Sym &sym, readArray<Sym>(dynsym)) {
+            symbolNames.push_back(strings.getString(sym.st_name));
+
+            if (sym.st_shndx != SHN_UNDEF && sym.st_value && !symbolNames.back().isEmpty() &&
+                !module_->symbols().contains(sym.st_value))
+            {
+                module_->addName(sym.st_value, symbolNames.back());
+            }
+        }
+
+        /*
+         * Find the GOT slots filled by the dynamic linker with the addresses of the symbols.
+         */
+        boost::unordered_map<ByteAddr, QString> slot2name;
+
+        for (std::size_t i = 0; i < shdrs.size(); ++i) {
+            const core::image::Section *section = module_->image()->sections()[initialSectionsCount + i];
+
+            if (shdrs[i].sh_type == SHT_RELA) {
+                foreach (const Rela &rela, readArray<Rela>(section)) {
+                    addGotSlot(ehdr.e_machine, rela.r_offset, rela.r_info, symbolNames, slot2name);
+                }
+            } else if (shdrs[i].sh_type == SHT_REL) {
+                foreach (const Rel &rel, readArray<Rel>(section)) {
+                    addGotSlot(ehdr.e_machine, rel.r_offset, rel.r_info, symbolNames, slot2name);
+                }
+            }
+        }
+
+        foreach (const auto &pair, slot2name) {
+            if (!module_->symbols().contains(pair.first)) {
+                module_->addName(pair.first, pair.second + QLatin1String("@got"));
+            }
+        }
+
+        /*
+         * Name the PLT stubs after the slots they jump through.
+         */
+        const core::image::Section *got = module_->image()->getSectionByName(".got.plt");
+        if (!got) {
+            got = module_->image()->getSectionByName(".got");
+        }
+
+        const char *pltNames[] = { ".plt", ".plt.sec", ".plt.got" };
+        foreach (const char *pltName, pltNames) {
+            if (const core::image::Section *plt = module_->image()->getSectionByName(QLatin1String(pltName))) {
+                nameStubs(ehdr.e_machine, plt, got, slot2name);
+            }
+        }
+    }
+
+    /**
+     * Remembers the GOT slot modified by a relocation, if it is
+     * a jump slot or a global data relocation of a named symbol.
+     *
+     * \param machine ELF machine id.
+     * \param offset Address of the relocated slot.
+     * \param info Relocation type and symbol index.
+     * \param symbolNames Names of the dynamic symbols.
+     * \param slot2name Mapping from a slot address to the name of its symbol.
+     */
+    template<class Info>
+    static void addGotSlot(unsigned machine, ByteAddr offset, Info info, const std::vector<QString> &symbolNames,
+                           boost::unordered_map<ByteAddr, QString> &slot2name)
+    {
+        std::size_t symbolIndex;
+        unsigned type;
+
+        if (sizeof(Info) == sizeof(Elf32_Word)) {
+            symbolIndex = ELF32_R_SYM(info);
+            type = ELF32_R_TYPE(info);
+        } else {
+            symbolIndex = static_cast<std::size_t>(ELF64_R_SYM(static_cast<uint64_t>(info)));
+            type = static_cast<unsigned>(ELF64_R_TYPE(static_cast<uint64_t>(info)));
+        }
+
+        bool isGotSlot;
+        switch (machine) {
+            case EM_386:
+                isGotSlot = type == R_386_JMP_SLOT || type == R_386_GLOB_DAT;
+                break;
+            case EM_X86_64:
+                isGotSlot = type == R_X86_64_JMP_SLOT || type == R_X86_64_GLOB_DAT;
+                break;
+            default:
+                isGotSlot = false;
+                break;
+        }
+
+        if (isGotSlot && symbolIndex < symbolNames.size() && !symbolNames[symbolIndex].isEmpty()) {
+            slot2name[offset] = symbolNames[symbolIndex];
+        }
+    }
+
+    /**
+     * Names the entries of a PLT section after the GOT slots they jump through
+     * and records the entries as stubs of these slots in the module.
+     *
+     * \param machine ELF machine id.
+     * \param plt Valid pointer to the PLT section.
+     * \param got Pointer to the GOT section, used as the base of position-independent
+     *            i386 stubs. Can be NULL.
+     * \param slot2name Mapping from a slot address to the name of its symbol.
+     */
+    void nameStubs(unsigned machine, const core::image::Section *plt, const core::image::Section *got,
+                   const boost::unordered_map<ByteAddr, QString> &slot2name)
+    {
+        assert(plt != NULL);
+
+        std::vector<unsigned char> bytes(static_cast<std::size_t>(plt->size()));
+        if (bytes.empty()) {
+            return;
+        }
+        bytes.resize(static_cast<std::size_t>(plt->readBytes(plt->addr(), &bytes[0], bytes.size())));
+
+        /* Stubs are 16 bytes long, except for the 8-byte ones without IBT in .plt.got. */
+        std::size_t stubSize = plt->name() == QLatin1String(".plt.got") && !startsWithEndbr(bytes) ? 8 : 16;
+
+        for (std::size_t stub = 0; stub + stubSize <= bytes.size(); stub += stubSize) {
+            /* Look for jmp *slot: ff 25 (absolute or RIP-relative) or ff a3 (relative to %ebx holding the GOT address). */
+            for (std::size_t i = stub; i + 6 <= stub + stubSize; ++i) {
+                if (bytes[i] != 0xff || (bytes[i + 1] != 0x25 && bytes[i + 1] != 0xa3)) {
+                    continue;
+                }
+
+                int32_t displacement;
+                memcpy(&displacement, &bytes[i + 2], sizeof(displacement));
+
+                ByteAddr slot;
+                if (bytes[i + 1] == 0xa3) {
+                    if (machine != EM_386 || !got) {
                         break;
                     }
-                    module_->addName(sym.st_value, strtab->readAsciizString(sym.st_name, strtab->size()));
+                    slot = got->addr() + displacement;
+                } else if (machine == EM_X86_64) {
+                    slot = plt->addr() + i + 6 + displacement;
+                } else {
+                    slot = static_cast<uint32_t>(displacement);
+                }
+
+                auto j = slot2name.find(slot);
+                if (j != slot2name.end()) {
+                    module_->addStub(plt->addr() + stub, slot);
+                    if (!module_->symbols().contains(plt->addr() + stub)) {
+                        module_->addName(plt->addr() + stub, j->second);
+                    }
                 }
+                break;
             }
         }
     }
+
+    /**
+     * \param bytes Contents of a PLT section.
+     *
+     * \return True if the section starts with an endbr32 or endbr64 instruction.
+     */
+    static bool startsWithEndbr(const std::vector<unsigned char> &bytes) {
+        return bytes.size() >= 4 && bytes[0] == 0xf3 && bytes[1] == 0x0f && bytes[2] == 0x1e &&
+               (bytes[3] == 0xfa || bytes[3] == 0xfb);
+    }
 };
 
 } // anonymous namespace
@@ -21,8 +21,10 @@
 
 #include "PeParser.h"
 
+#include <algorithm> /* std::min() */
+
 #include <QCoreApplication> /* For Q_DECLARE_TR_FUNCTIONS. */
-#include <QIODevice>
+#include <QFile>
 
 #include <nc/common/Conversions.h>
 #include <nc/common/Foreach.h>
@@ -31,6 +33,8 @@
 #include <nc/core/Module.h>
 #include <nc/core/image/BufferByteSource.h>
 #include <nc/core/image/Image.h>
+#include <nc/core/image/MappedFile.h>
+#include <nc/core/image/MappedFileByteSource.h>
 #include <nc/core/input/ParseError.h>
 
 #include "pe.h"
@@ -41,6 +45,9 @@ namespace pe {
 
 namespace {
 
+/** Maximal length of an imported or exported name. */
+const ByteSize MAX_NAME_SIZE = 4096;
+
 bool seekFileHeader(QIODevice *source) {
     IMAGE_DOS_HEADER dosHeader;
 
@@ -73,15 +80,29 @@ class PeParserPrivate {
 
     QIODevice *source_;
     core::Module *module_;
+    std::shared_ptr<const core::image::MappedFile> mappedFile_;
 
     std::unique_ptr<char[]> stringTable_;
     uint32_t stringTableSize_;
 
+    /** Address the image is loaded at. Relative virtual addresses are relative to it. */
+    ByteAddr imageBase_;
+
+    /** Sections in the order of their headers. */
+    std::vector<core::image::Section *> sections_;
+
     public:
 
     PeParserPrivate(QIODevice *source, core::Module *module):
-        source_(source), module_(module), stringTableSize_(0)
-    {}
+        source_(source), module_(module), stringTableSize_(0), imageBase_(0)
+    {
+        if (QFile *file = qobject_cast<QFile *>(source)) {
+            auto mappedFile = std::make_shared<core::image::MappedFile>(file->fileName());
+            if (mappedFile->data()) {
+                mappedFile_ = mappedFile;
+            }
+        }
+    }
 
     void parse() {
         if (!seekFileHeader(source_)) {
@@ -96,11 +117,11 @@ class PeParserPrivate {
         switch (fileHeader.Machine) {
             case IMAGE_FILE_MACHINE_I386:
                 module_->setArchitecture(QLatin1String("i386"));
-                parseHeaders<IMAGE_OPTIONAL_HEADER32, IMAGE_NT_OPTIONAL_HDR32_MAGIC>(fileHeader);
+                parseHeaders<IMAGE_OPTIONAL_HEADER32, IMAGE_NT_OPTIONAL_HDR32_MAGIC, DWORD, IMAGE_ORDINAL_FLAG32>(fileHeader);
                 break;
             case IMAGE_FILE_MACHINE_AMD64:
                 module_->setArchitecture(QLatin1String("x86-64"));
-                parseHeaders<IMAGE_OPTIONAL_HEADER64, IMAGE_NT_OPTIONAL_HDR64_MAGIC>(fileHeader);
+                parseHeaders<IMAGE_OPTIONAL_HEADER64, IMAGE_NT_OPTIONAL_HDR64_MAGIC, ULONGLONG, IMAGE_ORDINAL_FLAG64>(fileHeader);
                 break;
             default:
                 throw core::input::ParseError(tr("Unknown machine id: %1.").arg(fileHeader.Machine));
@@ -132,14 +153,26 @@ class PeParserPrivate {
                 throw core::input::ParseError(tr("Cannot read the string table."));
             }
 
-            foreach (const IMAGE_SYMBOL &symbol, symbols) {
+            for (std::size_t i = 0; i < symbols.size(); i += 1 + symbols[i].NumberOfAuxSymbols) {
+                const IMAGE_SYMBOL &symbol = symbols[i];
+
+                /* Values of symbols defined in sections are offsets in these sections. */
+                ByteAddr addr;
+                if (symbol.SectionNumber > 0 && static_cast<std::size_t>(symbol.SectionNumber) <= sections_.size()) {
+                    addr = sections_[symbol.SectionNumber - 1]->addr() + symbol.Value;
+                } else if (symbol.SectionNumber == IMAGE_SYM_ABSOLUTE) {
+                    addr = symbol.Value;
+                } else {
+                    continue;
+                }
+
                 QString name;
                 if (symbol.N.Name.Short) {
                     name = getString(symbol.N.ShortName);
                 } else {
                     name = getStringFromTable(symbol.N.Name.Long);
                 }
-                module_->addName(symbol.Value, name);
+                module_->addName(addr, name);
             }
 
             foreach (core::image::Section *section, module_->image()->sections()) {
@@ -156,7 +189,7 @@ class PeParserPrivate {
         }
     }
 
-    template<class OptionalHeader, WORD OptionalHeaderMagic>
+    template<class OptionalHeader, WORD OptionalHeaderMagic, class Thunk, Thunk OrdinalFlag>
     void parseHeaders(const IMAGE_FILE_HEADER &fileHeader) {
         OptionalHeader optionalHeader;
         if (source_->read(reinterpret_cast<char *>(&optionalHeader), sizeof(optionalHeader)) != sizeof(optionalHeader)) {
@@ -166,14 +199,31 @@ class PeParserPrivate {
             throw core::input::ParseError(tr("Magic of the optional header doesn't match."));
         }
 
+        imageBase_ = optionalHeader.ImageBase;
+
+        if (optionalHeader.AddressOfEntryPoint) {
+            module_->setEntryPoint(imageBase_ + optionalHeader.AddressOfEntryPoint);
+        }
+
         for (std::size_t i = 0; i < fileHeader.NumberOfSections; ++i) {
             IMAGE_SECTION_HEADER sectionHeader;
             if (source_->read(reinterpret_cast<char *>(&sectionHeader), sizeof(sectionHeader)) != sizeof(sectionHeader)) {
                 throw core::input::ParseError(tr("Cannot read section header #%1.").arg(i));
             }
 
+            /* Object files have no virtual size: the whole raw data is the section. */
+            ByteSize size = sectionHeader.Misc.VirtualSize ? sectionHeader.Misc.VirtualSize : sectionHeader.SizeOfRawData;
+
+            /* Do not trust the virtual size to stay within the image. */
+            if (sectionHeader.VirtualAddress < optionalHeader.SizeOfImage) {
+                size = std::min<ByteSize>(size, optionalHeader.SizeOfImage - sectionHeader.VirtualAddress);
+            } else {
+                size = std::min<ByteSize>(size, sectionHeader.SizeOfRawData);
+            }
+
             core::image::Section *section = module_->image()->createSection(
-                getString(sectionHeader.Name), sectionHeader.VirtualAddress, sectionHeader.SizeOfRawData);
+                getString(sectionHeader.Name), imageBase_ + sectionHeader.VirtualAddress, size);
+            sections_.push_back(section);
 
             section->setAllocated((sectionHeader.Characteristics & IMAGE_SCN_MEM_DISCARDABLE) == 0);
             section->setReadable(sectionHeader.Characteristics & IMAGE_SCN_MEM_READ);
@@ -184,16 +234,151 @@ class PeParserPrivate {
             section->setData(sectionHeader.Characteristics & IMAGE_SCN_CNT_INITIALIZED_DATA);
             section->setBss(sectionHeader.Characteristics & IMAGE_SCN_CNT_UNINITIALIZED_DATA);
 
-            auto pos = source_->pos();
-            if (source_->seek(sectionHeader.PointerToRawData)) {
-                section->setExternalByteSource(std::make_unique<core::image::BufferByteSource>(source_->read(sectionHeader.SizeOfRawData)));
+            /* The part of the section not backed by raw data is zero-filled. */
+            ByteSize rawSize = std::min<ByteSize>(sectionHeader.SizeOfRawData, size);
+
+            if (mappedFile_ || rawSize == 0) {
+                section->setExternalByteSource(std::make_unique<core::image::MappedFileByteSource>(
+                    mappedFile_, sectionHeader.PointerToRawData, rawSize, size));
+            } else {
+                auto pos = source_->pos();
+                if (source_->seek(sectionHeader.PointerToRawData)) {
+                    QByteArray bytes = source_->read(rawSize);
+                    section->setExternalByteSource(std::make_unique<core::image::BufferByteSource>(bytes, size - bytes.size()));
+                }
+                source_->seek(pos);
+            }
+        }
+
+        if (optionalHeader.NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_EXPORT) {
+            parseExports(optionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT]);
+        }
+        if (optionalHeader.NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_IMPORT) {
+            parseImports<Thunk, OrdinalFlag>(optionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT]);
+        }
+    }
+
+    /**
+     * Gives names to the exported functions.
+     *
+     * \param directory Export directory.
+     */
+    void parseExports(const IMAGE_DATA_DIRECTORY &directory) {
+        if (!directory.VirtualAddress || !directory.Size) {
+            return;
+        }
+
+        const core::image::Image *image = module_->image();
+
+        IMAGE_EXPORT_DIRECTORY exportDirectory;
+        if (image->readBytes(imageBase_ + directory.VirtualAddress, &exportDirectory, sizeof(exportDirectory)) != sizeof(exportDirectory)) {
+            return;
+        }
+
+        ByteAddr names = imageBase_ + exportDirectory.AddressOfNames;
+        ByteAddr ordinals = imageBase_ + exportDirectory.AddressOfNameOrdinals;
+        ByteAddr functions = imageBase_ + exportDirectory.AddressOfFunctions;
+
+        ByteSize namesCount = std::min(std::min<ByteSize>(exportDirectory.NumberOfNames,
+            getMaxEntryCount(names, sizeof(DWORD))), getMaxEntryCount(ordinals, sizeof(WORD)));
+        ByteSize functionsCount = std::min<ByteSize>(exportDirectory.NumberOfFunctions,
+            getMaxEntryCount(functions, sizeof(DWORD)));
+
+        for (ByteSize i = 0; i < namesCount; ++i) {
+            auto nameAddr = image->readType<DWORD>(names + i * sizeof(DWORD));
+            auto ordinal = image->readType<WORD>(ordinals + i * sizeof(WORD));
+            if (!nameAddr || !ordinal || *ordinal >= functionsCount) {
+                continue;
+            }
+
+            auto functionAddr = image->readType<DWORD>(functions + *ordinal * sizeof(DWORD));
+            if (!functionAddr || !*functionAddr) {
+                continue;
+            }
+
+            /* Forwarders point to strings inside the export directory. */
+            if (directory.VirtualAddress <= *functionAddr && *functionAddr < directory.VirtualAddress + directory.Size) {
+                continue;
+            }
+
+            QString name = image->readAsciizString(imageBase_ + *nameAddr, MAX_NAME_SIZE);
+            if (!name.isEmpty() && !module_->symbols().contains(imageBase_ + *functionAddr)) {
+                module_->addName(imageBase_ + *functionAddr, name);
+            }
+        }
+    }
+
+    /**
+     * Gives names to the import address table slots.
+     *
+     * \tparam Thunk Type of an import address table entry.
+     * \tparam OrdinalFlag Flag marking the entries imported by ordinal.
+     *
+     * \param directory Import directory.
+     */
+    template<class Thunk, Thunk OrdinalFlag>
+    void parseImports(const IMAGE_DATA_DIRECTORY &directory) {
+        if (!directory.VirtualAddress || !directory.Size) {
+            return;
+        }
+
+        const core::image::Image *image = module_->image();
+
+        ByteAddr descriptors = imageBase_ + directory.VirtualAddress;
+        ByteSize descriptorsCount = std::min<ByteSize>(directory.Size / sizeof(IMAGE_IMPORT_DESCRIPTOR),
+            getMaxEntryCount(descriptors, sizeof(IMAGE_IMPORT_DESCRIPTOR)));
+
+        for (ByteSize d = 0; d < descriptorsCount; ++d) {
+            IMAGE_IMPORT_DESCRIPTOR descriptor;
+            if (image->readBytes(descriptors + d * sizeof(descriptor), &descriptor, sizeof(descriptor)) != sizeof(descriptor) || !descriptor.FirstThunk) {
+                break;
+            }
+
+            QString libraryName = image->readAsciizString(imageBase_ + descriptor.Name, MAX_NAME_SIZE);
+            libraryName = libraryName.left(libraryName.lastIndexOf('.'));
+
+            /* The import address table may already be bound, so prefer the lookup table. */
+            ByteAddr lookupTable = imageBase_ + (descriptor.OriginalFirstThunk ? descriptor.OriginalFirstThunk : descriptor.FirstThunk);
+            ByteAddr addressTable = imageBase_ + descriptor.FirstThunk;
+
+            ByteSize thunksCount = std::min(getMaxEntryCount(lookupTable, sizeof(Thunk)), getMaxEntryCount(addressTable, sizeof(Thunk)));
+
+            for (ByteSize i = 0; i < thunksCount; ++i) {
+                auto thunk = image->readType<Thunk>(lookupTable + i * sizeof(Thunk));
+                if (!thunk || !*thunk) {
+                    break;
+                }
+
+                QString name;
+                if (*thunk & OrdinalFlag) {
+                    name = QString("%1_%2").arg(libraryName).arg(static_cast<WORD>(*thunk));
+                } else {
+                    /* Skip the hint. */
+                    name = image->readAsciizString(imageBase_ + (*thunk & 0x7fffffff) + sizeof(WORD), MAX_NAME_SIZE);
+                }
+
+                ByteAddr slot = addressTable + i * sizeof(Thunk);
+                if (!name.isEmpty() && !module_->symbols().contains(slot)) {
+                    module_->addName(slot, name);
+                }
             }
-            source_->seek(pos);
         }
     }
 
     private:
 
+    /**
+     * \param addr Virtual address.
+     * \param entrySize Size of an entry.
+     *
+     * \return Number of entries of the given size fitting between the address
+     *         and the end of the section containing it.
+     */
+    ByteSize getMaxEntryCount(ByteAddr addr, ByteSize entrySize) const {
+        const core::image::Section *section = module_->image()->getSectionContainingAddress(addr);
+        return section ? (section->endAddr() - addr) / entrySize : 0;
+    }
+
     template<std::size_t size>
     QString getString(const char (&buffer)[size]) const {
         return QString::fromLatin1(buffer, qstrnlen(buffer, size));
@@ -81,6 +81,9 @@ void inlineFunctions(nc::core::Context &context, std::vector<nc::ByteAddr> funct
         const nc::core::ir::Function *inlinedFunction = functions.front();
 
         foreach (nc::core::ir::Function *function, context.functions()->functions()) {
+            /* Calls are collected before inlining, so they must be taken from private basic blocks. */
+            function->unshare();
+
             std::vector<const nc::core::ir::Call *> calls;
 
             foreach (nc::core::ir::BasicBlock *basicBlock, function->basicBlocks()) {
@@ -112,6 +115,9 @@ void inlineCalls(nc::core::Context &context, std::vector<nc::ByteAddr> callAddre
     std::sort(callAddresses.begin(), callAddresses.end());
 
     foreach (nc::core::ir::Function *function, context.functions()->functions()) {
+        /* Calls are collected before inlining, so they must be taken from private basic blocks. */
+        function->unshare();
+
         std::vector<std::pair<const nc::core::ir::Call *, const nc::core::ir::Function *>> inlines;
 
         foreach (nc::core::ir::BasicBlock *basicBlock, function->basicBlocks()) {
@@ -186,6 +192,9 @@ void help() {
     qout << "Options:" << endl;
     qout << "  --help, -h                  Produce this help message and exit." << endl;
     qout << "  --list-parsers              List available parsers and exit." << endl;
+    qout << "  --threads=N                 Run per-function analyses in N threads." << endl;
+    qout << "  --recursive                 Disassemble only the code reachable from the entry point and symbols." << endl;
+    qout << "  --ssa                       Analyze dataflow over an SSA form of register and stack accesses." << endl;
     qout << "  --inline-function=ADDR      Inline a function with given address everywhere." << endl;
     qout << "  --inline-call=ADDR          Inline a call at given address." << endl;
     qout << "  --print-instructions[=FILE] Dump parsed instructions to the file." << endl;
@@ -221,6 +230,9 @@ int main(int argc, char *argv[]) {
         QString regionsFile;
         QString cxxFile;
         bool autoDefault = true;
+        int threadCount = 1;
+        bool recursive = false;
+        bool ssa = false;
 
         std::vector<nc::ByteAddr> functionAddresses;
         std::vector<nc::ByteAddr> callAddresses;
@@ -235,6 +247,15 @@ int main(int argc, char *argv[]) {
             } else if (arg == "--list-parsers") {
                 listParsers();
                 return 1;
+            } else if (arg == "--recursive") {
+                recursive = true;
+            } else if (arg == "--ssa") {
+                ssa = true;
+            } else if (arg.startsWith("--threads=")) {
+                QString s = arg.section('=', 1);
+                if (!nc::stringToInt<int>(s, &threadCount) || threadCount < 1) {
+                    throw nc::Exception(QString("bad number of threads: %1").arg(s));
+                }
 
             #define FILE_OPTION(option, variable)       \
             } else if (arg == option) {                 \
@@ -287,6 +308,8 @@ int main(int argc, char *argv[]) {
         }
 
         nc::core::Context context;
+        context.setThreadCount(threadCount);
+        context.setSparseDataflow(ssa);
 
         foreach (const QString &filename, files) {
             try {
@@ -306,7 +329,11 @@ int main(int argc, char *argv[]) {
 
         openFileForWritingAndCall(sectionsFile,     [&](QTextStream &out) { printSections(context, out); });
 
-        if (!instructionsFile.isEmpty()) {
+        if (recursive) {
+            if (!context.disassembleRecursively()) {
+                context.disassemble();
+            }
+        } else if (!instructionsFile.isEmpty()) {
             context.disassemble();
         }
         openFileForWritingAndCall(instructionsFile, [&](QTextStream &out) { context.instructions()->print(out); });